@@ -0,0 +1,19 @@
+#ifndef __S21BLAS_H__
+#define __S21BLAS_H__
+
+// vendor kernels for builds with BACKEND=blas: CBLAS for the products and
+// the plain LAPACK routines, which OpenBLAS and reference LAPACK both export
+#ifdef S21_USE_BLAS
+#include <cblas.h>
+
+extern "C" {
+void dgetrf_(const int* m, const int* n, double* a, const int* lda, int* ipiv,
+             int* info);
+void dgetri_(const int* n, double* a, const int* lda, const int* ipiv,
+             double* work, const int* lwork, int* info);
+void dgesv_(const int* n, const int* nrhs, double* a, const int* lda,
+            int* ipiv, double* b, const int* ldb, int* info);
+}
+#endif
+
+#endif
@@ -0,0 +1,345 @@
+#include "s21_executor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+
+#include "s21_numa.h"
+
+namespace {
+
+// the executor the calling thread works for and its index there; nullptr
+// and -1 outside any
+thread_local const S21Executor* workerOwner = nullptr;
+thread_local int workerIndex = -1;
+
+}  // namespace
+
+S21Executor::S21Executor(int threads, bool pinned)
+    : _stop(false), _pinned(pinned) {
+  if (threads <= 0) {
+    threads = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  if (threads <= 0) {
+    threads = 1;
+  }
+  for (int i = 0; i < threads; ++i) {
+    _workers.emplace_back(&S21Executor::workerLoop, this, i);
+    const std::vector<int>& cpus = s21NumaCpus();
+    if (pinned && !cpus.empty()) {
+      s21PinThread(_workers.back(), cpus[i % cpus.size()]);
+    }
+  }
+}
+
+S21Executor::~S21Executor() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _cv.notify_all();
+  for (std::thread& worker : _workers) {
+    worker.join();
+  }
+}
+
+void S21Executor::workerLoop(int index) {
+  workerOwner = this;
+  workerIndex = index;
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _cv.wait(lock, [this] { return _stop || !_tasks.empty(); });
+      if (_tasks.empty()) {
+        return;
+      }
+      task = std::move(_tasks.front());
+      _tasks.pop_front();
+    }
+    task();
+  }
+}
+
+void S21Executor::Submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _tasks.push_back(std::move(task));
+  }
+  _cv.notify_one();
+}
+
+void S21Executor::ParallelFor(int begin, int end, int grain,
+                              const std::function<void(int, int)>& body) {
+  if (end <= begin) {
+    return;
+  }
+  grain = std::max(grain, 1);
+  if (_pinned) {
+    const int blocks =
+        std::min((end - begin + grain - 1) / grain, getThreads());
+    // a worker cannot wait for all workers, itself included
+    if (blocks <= 1 || isWorker()) {
+      body(begin, end);
+      return;
+    }
+    const long long length = end - begin;
+    ForEachWorker([&](int worker) {
+      if (worker < blocks) {
+        body(begin + static_cast<int>(length * worker / blocks),
+             begin + static_cast<int>(length * (worker + 1) / blocks));
+      }
+    });
+    return;
+  }
+  const int chunks =
+      std::min((end - begin + grain - 1) / grain, 4 * getThreads());
+  if (chunks <= 1) {
+    body(begin, end);
+    return;
+  }
+  struct Shared {
+    std::atomic<int> next{0};
+    std::atomic<int> done{0};
+    std::exception_ptr error;  // first exception thrown by body
+    std::mutex mutex;
+    std::condition_variable cv;
+
+    void finish(int count, int chunks) {
+      if ((done += count) == chunks) {
+        std::lock_guard<std::mutex> lock(mutex);
+        cv.notify_all();
+      }
+    }
+  };
+  std::shared_ptr<Shared> shared = std::make_shared<Shared>();
+  const int length = end - begin;
+  // each participant claims chunks until none are left; helpers that start
+  // late find nothing to do, so the caller never waits on a queued task.
+  // After an exception the unclaimed chunks are dropped, and the caller
+  // rethrows once the chunks already running are done with body.
+  auto work = [shared, &body, begin, length, chunks] {
+    auto bound = [&](int c) {
+      return begin + static_cast<int>(static_cast<long long>(length) * c /
+                                      chunks);
+    };
+    for (int c; (c = shared->next++) < chunks;) {
+      try {
+        body(bound(c), bound(c + 1));
+      } catch (...) {
+        {
+          std::lock_guard<std::mutex> lock(shared->mutex);
+          if (!shared->error) shared->error = std::current_exception();
+        }
+        const int claimed = std::min(shared->next.exchange(chunks), chunks);
+        shared->finish(chunks - claimed, chunks);
+      }
+      shared->finish(1, chunks);
+    }
+  };
+  const int helpers = std::min(chunks, getThreads()) - 1;
+  for (int i = 0; i < helpers; ++i) {
+    Submit(work);
+  }
+  work();
+  std::unique_lock<std::mutex> lock(shared->mutex);
+  shared->cv.wait(lock, [&] { return shared->done == chunks; });
+  if (shared->error) {
+    std::rethrow_exception(shared->error);
+  }
+}
+
+void S21Executor::ForEachWorker(const std::function<void(int)>& body) {
+  if (isWorker()) {
+    throw std::logic_error("ForEachWorker called from its own worker");
+  }
+  // the tasks of two concurrent calls would interleave in the queue, and
+  // workers holding tasks of both calls would wait on each other
+  std::lock_guard<std::mutex> serial(_broadcast);
+  struct Shared {
+    int started = 0;
+    int done = 0;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable cv;
+  };
+  std::shared_ptr<Shared> shared = std::make_shared<Shared>();
+  const int count = getThreads();
+  // a worker holding one of these tasks waits until every task has been
+  // picked up, so no worker can take two of them
+  for (int i = 0; i < count; ++i) {
+    Submit([shared, &body, count] {
+      {
+        std::unique_lock<std::mutex> lock(shared->mutex);
+        if (++shared->started == count) shared->cv.notify_all();
+        shared->cv.wait(lock, [&] { return shared->started == count; });
+      }
+      std::exception_ptr error;
+      try {
+        body(workerIndex);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      std::lock_guard<std::mutex> lock(shared->mutex);
+      if (error && !shared->error) shared->error = error;
+      if (++shared->done == count) shared->cv.notify_all();
+    });
+  }
+  std::unique_lock<std::mutex> lock(shared->mutex);
+  shared->cv.wait(lock, [&] { return shared->done == count; });
+  if (shared->error) {
+    std::rethrow_exception(shared->error);
+  }
+}
+
+int S21Executor::getThreads() const {
+  return static_cast<int>(_workers.size());
+}
+
+bool S21Executor::isPinned() const { return _pinned; }
+
+bool S21Executor::isWorker() const { return workerOwner == this; }
+
+S21Executor& S21Executor::Default() {
+  static S21Executor executor;
+  return executor;
+}
+
+S21Executor& S21Executor::Pinned() {
+  static S21Executor executor(0, true);
+  return executor;
+}
+
+int S21TaskGraph::Add(std::function<void()> task,
+                      const std::vector<int>& after) {
+  const int id = static_cast<int>(_nodes.size());
+  std::vector<int> deps(after);
+  std::sort(deps.begin(), deps.end());
+  deps.erase(std::unique(deps.begin(), deps.end()), deps.end());
+  if (!deps.empty() && (deps.front() < 0 || deps.back() >= id)) {
+    throw std::out_of_range("Incorrect input, index is out of range");
+  }
+  for (int d : deps) _nodes[d].successors.push_back(id);
+  _nodes.push_back(Node{std::move(task), {}, static_cast<int>(deps.size())});
+  return id;
+}
+
+void S21TaskGraph::Run(S21Executor* executor) {
+  const int count = getSize();
+  if (count == 0) {
+    return;
+  }
+  const int participants =
+      executor ? std::max(1, std::min(executor->getThreads(), count)) : 1;
+  struct Queue {
+    std::mutex mutex;
+    std::deque<int> tasks;
+  };
+  struct Shared {
+    const std::vector<Node>* nodes;
+    std::unique_ptr<std::atomic<int>[]> waiting;  // unfinished dependencies
+    std::vector<Queue> queues;
+    std::atomic<int> remaining;  // tasks not finished
+    std::atomic<int> ready{0};   // tasks sitting in a deque
+    std::atomic<int> joined{1};  // the caller is participant 0
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::mutex mutex;  // guards error and the sleeping participants
+    std::condition_variable cv;
+
+    Shared(const std::vector<Node>* graph, int count, int participants)
+        : nodes(graph),
+          waiting(new std::atomic<int>[count]),
+          queues(participants),
+          remaining(count) {}
+
+    void wakeAll() {
+      { std::lock_guard<std::mutex> lock(mutex); }
+      cv.notify_all();
+    }
+    // the back of its own deque, else the front of another one
+    int take(int self) {
+      const int n = static_cast<int>(queues.size());
+      for (int k = 0; k < n; ++k) {
+        Queue& q = queues[(self + k) % n];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (!q.tasks.empty()) {
+          int t;
+          if (k == 0) {
+            t = q.tasks.back();
+            q.tasks.pop_back();
+          } else {
+            t = q.tasks.front();
+            q.tasks.pop_front();
+          }
+          --ready;
+          return t;
+        }
+      }
+      return -1;
+    }
+    void execute(int t, int self) {
+      const Node& node = (*nodes)[t];
+      if (!failed) {
+        try {
+          node.task();
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (!error) error = std::current_exception();
+          failed = true;
+        }
+      }
+      int pushed = 0;
+      for (int s : node.successors) {
+        if (--waiting[s] == 0) {
+          std::lock_guard<std::mutex> lock(queues[self].mutex);
+          queues[self].tasks.push_back(s);
+          ++ready;
+          ++pushed;
+        }
+      }
+      // this thread takes one of the new tasks itself
+      if (pushed > 1) wakeAll();
+      if (--remaining == 0) wakeAll();
+    }
+    void work(int self) {
+      for (;;) {
+        const int t = take(self);
+        if (t >= 0) {
+          execute(t, self);
+          continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return remaining == 0 || ready > 0; });
+        if (remaining == 0) {
+          return;
+        }
+      }
+    }
+  };
+  std::shared_ptr<Shared> shared =
+      std::make_shared<Shared>(&_nodes, count, participants);
+  for (int t = 0; t < count; ++t) {
+    shared->waiting[t] = _nodes[t].deps;
+    if (_nodes[t].deps == 0) {
+      shared->queues[0].tasks.push_back(t);
+      ++shared->ready;
+    }
+  }
+  // helpers that start after the graph has finished find nothing to do and
+  // only touch the shared state they keep alive
+  for (int i = 1; i < participants; ++i) {
+    executor->Submit([shared] {
+      const int self = shared->joined++;
+      if (self < static_cast<int>(shared->queues.size())) shared->work(self);
+    });
+  }
+  shared->work(0);
+  if (shared->error) {
+    std::rethrow_exception(shared->error);
+  }
+}
+
+int S21TaskGraph::getSize() const { return static_cast<int>(_nodes.size()); }
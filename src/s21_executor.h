@@ -0,0 +1,83 @@
+#ifndef __S21EXECUTOR_H__
+#define __S21EXECUTOR_H__
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// fixed-size thread pool running the library's background work
+class S21Executor {
+ private:
+  std::vector<std::thread> _workers;
+  std::deque<std::function<void()>> _tasks;  // FIFO of pending tasks
+  std::mutex _mutex;
+  std::mutex _broadcast;  // one ForEachWorker at a time
+  std::condition_variable _cv;
+  bool _stop;
+  bool _pinned;
+
+  void workerLoop(int index);
+
+ public:
+  // 0 threads picks the number of cores; pinned binds each worker to its
+  // own CPU, spreading the workers over the NUMA nodes in turn
+  explicit S21Executor(int threads = 0, bool pinned = false);
+  S21Executor(const S21Executor&) = delete;
+  S21Executor& operator=(const S21Executor&) = delete;
+  ~S21Executor();  // runs what is still queued, then joins the workers
+
+  void Submit(std::function<void()> task);
+  // calls body(from, to) over [begin, end) split into pieces of at least
+  // grain; the caller works on the pieces too and returns when all are done.
+  // If body throws, the pieces not yet started are skipped and the first
+  // exception is rethrown on the caller. A pinned executor splits the range
+  // statically instead: block k of getThreads() equal blocks always runs on
+  // worker k, so a loop over the rows of a matrix allocated with
+  // S21Placement::kFirstTouch finds each block on its worker's node. Called
+  // from one of its own workers, a pinned executor runs body(begin, end) on
+  // that worker.
+  void ParallelFor(int begin, int end, int grain,
+                   const std::function<void(int, int)>& body);
+  // runs body(worker) once on each worker thread, worker = 0 ..
+  // getThreads() - 1, and rethrows the first exception. Concurrent calls
+  // run one after the other; a call from a worker of the same executor,
+  // which could never see every worker free, throws std::logic_error.
+  void ForEachWorker(const std::function<void(int)>& body);
+  int getThreads() const;
+  bool isPinned() const;
+  bool isWorker() const;  // the calling thread is one of the workers
+
+  static S21Executor& Default();  // shared pool used when none is given
+  static S21Executor& Pinned();   // shared pool of pinned workers
+};
+
+// tasks with dependencies, run once per Run. Every participant (the caller
+// and up to getThreads() - 1 workers of the executor) keeps its own deque:
+// tasks made ready by a finished task go to the back of the deque of the
+// thread that finished it and are taken from there first, so related work
+// stays in one cache, while idle participants steal from the front of the
+// others' deques.
+class S21TaskGraph {
+ private:
+  struct Node {
+    std::function<void()> task;
+    std::vector<int> successors;
+    int deps = 0;
+  };
+  std::vector<Node> _nodes;
+
+ public:
+  // adds a task that starts once every task in after has finished; the ids
+  // in after come from earlier Add calls, so the graph is always acyclic
+  int Add(std::function<void()> task, const std::vector<int>& after = {});
+  // without an executor the tasks run on the calling thread. If a task
+  // throws, the tasks not yet started are skipped and Run rethrows the
+  // first exception.
+  void Run(S21Executor* executor = nullptr);
+  int getSize() const;
+};
+
+#endif
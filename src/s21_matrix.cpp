@@ -1,62 +1,255 @@
 #include "s21_matrix_oop.h"
 
+#include <atomic>
+#include <cstdint>
+
+#include "s21_blas.h"
+#include "s21_numa.h"
+
+// the accessors are compiled here unless they are inline in the header
+#ifndef S21_INLINE_ACCESSORS
+#define S21_MATRIX_INLINE
+#include "s21_matrix_inline.h"
+#endif
+
+namespace {
+
+#ifdef S21_USE_BLAS
+std::atomic<S21Backend> backend{S21Backend::kBlas};
+#else
+std::atomic<S21Backend> backend{S21Backend::kNative};
+#endif
+
+std::atomic<bool> copyOnWrite{false};
+// source of S21Matrix::_id
+std::atomic<uint64_t> nextId{1};
+
+// elements are compared in blocks of this size: the block is checked without
+// branches and only a failing block is rescanned
+const size_t kCompareBlock = 256;
+
+// maps the bits of a double onto a monotonic integer scale, so the distance
+// between two mapped values is the number of representable doubles between
+inline int64_t orderedBits(double x) {
+  int64_t i;
+  std::memcpy(&i, &x, sizeof(i));
+  return i < 0 ? INT64_MIN - i : i;
+}
+
+inline uint64_t ulpDistance(double a, double b) {
+  int64_t ia = orderedBits(a), ib = orderedBits(b);
+  return ia > ib ? static_cast<uint64_t>(ia) - static_cast<uint64_t>(ib)
+                 : static_cast<uint64_t>(ib) - static_cast<uint64_t>(ia);
+}
+
+// the absolute and relative tests on plain doubles; std::max rather than
+// fmax and no short-circuits, so a loop over it vectorises on targets with
+// vector compares of doubles (gcc 12 needs at least SSE4.2, e.g. MARCH=native)
+// and stays branch-free elsewhere. NaN fails every comparison and so is out
+// of tolerance, as with the ulp test below
+inline bool withinAbsRel(double a, double b, double abs, double rel) {
+  const double diff = std::fabs(a - b);
+  return (a == b) | (diff <= abs) |
+         (diff <= rel * std::max(std::fabs(a), std::fabs(b)));
+}
+
+inline bool withinTolerance(double a, double b, const S21Tolerance& tol) {
+  return withinAbsRel(a, b, tol.abs, tol.rel) ||
+         (a == a && b == b &&
+          ulpDistance(a, b) <= static_cast<uint64_t>(tol.ulp));
+}
+
+// |a - b| where equal values (infinities included) give 0 and NaN gives inf
+inline double elementDiff(double a, double b) {
+  if (a == b) return 0;
+  double diff = std::fabs(a - b);
+  return std::isnan(diff) ? INFINITY : diff;
+}
+
+// index of the first element out of tolerance, or n if there is none
+size_t firstMismatch(const double* a, const double* b, size_t n,
+                     const S21Tolerance& tol) {
+  if (tol.ulp > 0) {
+    for (size_t k = 0; k < n; ++k) {
+      if (!withinTolerance(a[k], b[k], tol)) return k;
+    }
+    return n;
+  }
+  const double abs = tol.abs, rel = tol.rel;
+  for (size_t start = 0; start < n; start += kCompareBlock) {
+    const size_t end = std::min(n, start + kCompareBlock);
+    int bad = 0;
+    for (size_t k = start; k < end; ++k) {
+      bad |= !withinAbsRel(a[k], b[k], abs, rel);
+    }
+    if (bad) {
+      for (size_t k = start; k < end; ++k) {
+        if (!withinAbsRel(a[k], b[k], abs, rel)) return k;
+      }
+    }
+  }
+  return n;
+}
+
+}  // namespace
+
 S21Matrix::S21Matrix() {
   _rows = 0;
   _cols = 0;
+  _stride = 0;
   _matrix = nullptr;
+  _owner = true;
+  _refs = nullptr;
+  _id = nextId++;
+  _version = 0;
+  _cached = false;
 }
 
-S21Matrix::S21Matrix(int rows, int cols) : _rows(rows), _cols(cols) {
+S21Matrix::S21Matrix(int rows, int cols)
+    : _rows(rows),
+      _cols(cols),
+      _refs(nullptr),
+      _id(nextId++),
+      _version(0),
+      _cached(false) {
   if (rows <= 0 || cols <= 0) {
     throw std::invalid_argument("Wrong size of matrix");
   }
   createMatrix();
 }
 
-S21Matrix::S21Matrix(const S21Matrix& o) : _rows(o._rows), _cols(o._cols) {
-  createMatrix();
-  for (int i = 0; i < _rows; ++i) {
-    for (int j = 0; j < _cols; ++j) {
-      _matrix[i][j] = o._matrix[i][j];
-    }
+S21Matrix::S21Matrix(const S21Matrix& o)
+    : _rows(o._rows),
+      _cols(o._cols),
+      _refs(nullptr),
+      _id(nextId++),
+      _version(0),
+      _cached(false) {
+  if (o._refs) {
+    o._refs->fetch_add(1, std::memory_order_relaxed);
+    _stride = o._stride;
+    _matrix = o._matrix;
+    _owner = true;
+    _refs = o._refs;
+    return;
   }
+  createMatrix();
+  copyElements(o);
 }
 
-S21Matrix::S21Matrix(S21Matrix&& o) : _rows(o._rows), _cols(o._cols) {
+S21Matrix::S21Matrix(S21Matrix&& o)
+    : _rows(o._rows),
+      _cols(o._cols),
+      _stride(o._stride),
+      _owner(o._owner),
+      _refs(o._refs),
+      _id(nextId++),
+      _version(0),
+      _cached(false) {
   _matrix = o._matrix;
+  ++o._version;
   o._rows = 0;
   o._cols = 0;
+  o._stride = 0;
   o._matrix = nullptr;
+  o._owner = true;
+  o._refs = nullptr;
 }
 
-S21Matrix::~S21Matrix() { deleteMatrix(); }
+S21Matrix::~S21Matrix() {
+  if (_cached.load(std::memory_order_relaxed)) {
+    forgetCached(_id);
+  }
+  deleteMatrix();
+}
 
 void S21Matrix::createMatrix() {
-  _matrix = new double*[_rows];
-  for (int i = 0; i < _rows; ++i) {
-    _matrix[i] = new double[_cols]();
-  }
+  _stride = _cols;
+  _matrix = size() ? s21AllocBuffer(size()) : nullptr;
+  _owner = true;
+  _refs = _matrix && copyOnWrite ? new std::atomic<int>(1) : nullptr;
 }
 
 void S21Matrix::deleteMatrix() {
+  // the last owner of a shared buffer frees it
+  if (!_refs || _refs->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    if (_owner) {
+      s21FreeBuffer(_matrix, size());
+    }
+    delete _refs;
+  }
+  _matrix = nullptr;
+  _owner = true;
+  _refs = nullptr;
+}
+
+void S21Matrix::detach() {
+  if (_refs->load(std::memory_order_acquire) == 1) {
+    return;
+  }
+  S21Matrix copy(_rows, _cols);
+  copy.copyElements(*this);
+  *this = std::move(copy);
+}
+
+void S21Matrix::copyElements(const S21Matrix& o) {
+  if (_stride == _cols && o._stride == o._cols) {
+    std::copy(o._matrix, o._matrix + o.size(), _matrix);
+    return;
+  }
   for (int i = 0; i < _rows; ++i) {
-    delete[] _matrix[i];
+    std::copy(o.rowPtr(i), o.rowPtr(i) + _cols, rowPtr(i));
   }
-  delete[] _matrix;
 }
 
-bool S21Matrix::EqMatrix(const S21Matrix& o) {
-  bool res = true;
+bool S21Matrix::EqMatrix(const S21Matrix& o) const { return Compare(o).equal; }
+
+bool S21Matrix::EqMatrix(const S21Matrix& o,
+                          const S21Tolerance& tol) const {
+  return Compare(o, tol).equal;
+}
+
+S21CompareResult S21Matrix::Compare(const S21Matrix& o,
+                                    const S21Tolerance& tol,
+                                    S21CompareMode mode) const {
+  S21CompareResult res;
   if (_rows != o._rows || _cols != o._cols) {
-    res = false;
+    res.equal = false;
+    return res;
   }
-  for (int i = 0; i < _rows && res; ++i) {
-    for (int j = 0; j < _cols && res; ++j) {
-      if (fabs(_matrix[i][j] - o._matrix[i][j]) > EPS) {
-        res = false;
+  // contiguous operands are scanned as one long row
+  const bool flat = _stride == _cols && o._stride == o._cols;
+  const int rows = flat ? 1 : _rows;
+  const size_t len = flat ? size() : _cols, n = size();
+  size_t at = n;
+  bool bad = false;
+  for (int i = 0; i < rows && (mode == S21CompareMode::kMax || !bad); ++i) {
+    const double* a = flat ? _matrix : rowPtr(i);
+    const double* b = flat ? o._matrix : o.rowPtr(i);
+    if (mode == S21CompareMode::kFirst) {
+      size_t k = firstMismatch(a, b, len, tol);
+      if (k < len) {
+        bad = true;
+        at = i * len + k;
+      }
+      continue;
+    }
+    for (size_t k = 0; k < len; ++k) {
+      double diff = elementDiff(a[k], b[k]);
+      if (diff > res.diff) {
+        res.diff = diff;
+        at = i * len + k;
       }
+      bad |= !withinTolerance(a[k], b[k], tol);
     }
   }
+  res.equal = !bad;
+  if (at < n) {
+    res.row = static_cast<int>(at / _cols);
+    res.col = static_cast<int>(at % _cols);
+    res.diff =
+        elementDiff(rowPtr(res.row)[res.col], o.rowPtr(res.row)[res.col]);
+  }
   return res;
 }
 
@@ -64,9 +257,10 @@ void S21Matrix::SumMatrix(const S21Matrix& o) {
   if (_rows != o._rows || _cols != o._cols) {
     throw std::invalid_argument("Different size of matrix");
   }
+  makeUnique();
   for (int i = 0; i < _rows; ++i) {
     for (int j = 0; j < _cols; ++j) {
-      _matrix[i][j] += o._matrix[i][j];
+      rowPtr(i)[j] += o.rowPtr(i)[j];
     }
   }
 }
@@ -75,9 +269,10 @@ void S21Matrix::SubMatrix(const S21Matrix& o) {
   if (_rows != o._rows || _cols != o._cols) {
     throw std::invalid_argument("Different size of matrix");
   }
+  makeUnique();
   for (int i = 0; i < _rows; ++i) {
     for (int j = 0; j < _cols; ++j) {
-      _matrix[i][j] -= o._matrix[i][j];
+      rowPtr(i)[j] -= o.rowPtr(i)[j];
     }
   }
 }
@@ -87,52 +282,138 @@ void S21Matrix::MulMatrix(const S21Matrix& o) {
     throw std::invalid_argument("Wrong size of matrixes");
   }
   S21Matrix res(_rows, o._cols);
-  for (int i = 0; i < _rows; ++i) {
-    for (int j = 0; j < o._cols; ++j) {
-      for (int k = 0; k < _cols; ++k) {
-        res._matrix[i][j] += this->_matrix[i][k] * o._matrix[k][j];
+  res.Gemm(S21Op::kNoTrans, S21Op::kNoTrans, 1, *this, o, 0);
+  *this = std::move(res);
+}
+
+void S21Matrix::Gemm(S21Op op_a, S21Op op_b, double alpha, const S21Matrix& a,
+                     const S21Matrix& b, double beta) {
+  const bool trans_a = op_a == S21Op::kTrans, trans_b = op_b == S21Op::kTrans;
+  const int m = trans_a ? a._cols : a._rows, k = trans_a ? a._rows : a._cols;
+  const int n = trans_b ? b._rows : b._cols;
+  if (k != (trans_b ? b._cols : b._rows)) {
+    throw std::invalid_argument("Wrong size of matrixes");
+  }
+  if (beta != 0 && (_rows != m || _cols != n)) {
+    throw std::invalid_argument("Different size of matrix");
+  }
+  if (this == &a || this == &b || _rows != m || _cols != n) {
+    S21Matrix res(m, n);
+    if (beta != 0) {
+      res.copyElements(*this);
+    }
+    res.Gemm(op_a, op_b, alpha, a, b, beta);
+    *this = std::move(res);
+    return;
+  }
+  makeUnique();
+
+#ifdef S21_USE_BLAS
+  if (getBackend() == S21Backend::kBlas) {
+    cblas_dgemm(CblasRowMajor, trans_a ? CblasTrans : CblasNoTrans,
+                trans_b ? CblasTrans : CblasNoTrans, m, n, k, alpha,
+                a._matrix, a._stride, b._matrix, b._stride, beta, _matrix,
+                _stride);
+    return;
+  }
+#endif
+  for (int i = 0; i < m; ++i) {
+    double* c = rowPtr(i);
+    for (int j = 0; j < n; ++j) c[j] = beta == 0 ? 0 : beta * c[j];
+  }
+  // loop orders keep the innermost loop on contiguous rows of the operands
+  if (!trans_a && !trans_b) {
+    for (int i = 0; i < m; ++i) {
+      double* c = rowPtr(i);
+      const double* ar = a.rowPtr(i);
+      for (int p = 0; p < k; ++p) {
+        const double t = alpha * ar[p];
+        const double* br = b.rowPtr(p);
+        for (int j = 0; j < n; ++j) c[j] += t * br[j];
+      }
+    }
+  } else if (trans_a && !trans_b) {
+    for (int p = 0; p < k; ++p) {
+      const double* ar = a.rowPtr(p);
+      const double* br = b.rowPtr(p);
+      for (int i = 0; i < m; ++i) {
+        const double t = alpha * ar[i];
+        double* c = rowPtr(i);
+        for (int j = 0; j < n; ++j) c[j] += t * br[j];
+      }
+    }
+  } else if (!trans_a && trans_b) {
+    for (int i = 0; i < m; ++i) {
+      double* c = rowPtr(i);
+      const double* ar = a.rowPtr(i);
+      for (int j = 0; j < n; ++j) {
+        const double* br = b.rowPtr(j);
+        double s = 0;
+        for (int p = 0; p < k; ++p) s += ar[p] * br[p];
+        c[j] += alpha * s;
+      }
+    }
+  } else {
+    // op(b) = b^T is packed first, so its rows are contiguous as well
+    std::vector<double> bt(static_cast<size_t>(k) * n);
+    for (int j = 0; j < n; ++j) {
+      const double* br = b.rowPtr(j);
+      for (int p = 0; p < k; ++p) bt[static_cast<size_t>(p) * n + j] = br[p];
+    }
+    for (int p = 0; p < k; ++p) {
+      const double* ar = a.rowPtr(p);
+      const double* br = bt.data() + static_cast<size_t>(p) * n;
+      for (int i = 0; i < m; ++i) {
+        const double t = alpha * ar[i];
+        double* c = rowPtr(i);
+        for (int j = 0; j < n; ++j) c[j] += t * br[j];
       }
     }
   }
-  *this = res;
 }
 
 void S21Matrix::MulNumber(const double num) {
+  makeUnique();
   for (int i = 0; i < this->_rows; ++i) {
     for (int j = 0; j < this->_cols; ++j) {
-      this->_matrix[i][j] *= num;
+      this->rowPtr(i)[j] *= num;
     }
   }
 }
 
-S21Matrix S21Matrix::Transpose() {
+S21Matrix S21Matrix::Transpose() const {
   S21Matrix res(_cols, _rows);
   for (int i = 0; i < this->_rows; ++i) {
     for (int j = 0; j < this->_cols; ++j) {
-      res._matrix[j][i] = _matrix[i][j];
+      res.rowPtr(j)[i] = rowPtr(i)[j];
     }
   }
   return res;
 }
 
-double S21Matrix::Determinant() {
+double S21Matrix::Determinant() const {
   if (_rows != _cols) {
     throw std::invalid_argument("Matrix is not sqared");
   }
+#ifdef S21_USE_BLAS
+  if (getBackend() == S21Backend::kBlas) {
+    return blasDeterminant();
+  }
+#endif
   double res = 0;
   if (_rows == 1) {
-    res += this->_matrix[0][0];
+    res += this->rowPtr(0)[0];
   } else {
     for (int i = 0; i < _cols; ++i) {
       S21Matrix minor;
       minor = this->createMinor(0, i);
-      res += this->_matrix[0][i] * (((i) % 2) ? -1 : 1) * minor.Determinant();
+      res += this->rowPtr(0)[i] * (((i) % 2) ? -1 : 1) * minor.Determinant();
     }
   }
   return res;
 }
 
-S21Matrix S21Matrix::createMinor(int row, int col) {
+S21Matrix S21Matrix::createMinor(int row, int col) const {
   S21Matrix res(this->_rows - 1, this->_cols - 1);
   int offset_row = 0, offset_col = 0;
   for (int i = 0; i < res._rows; ++i) {
@@ -144,13 +425,13 @@ S21Matrix S21Matrix::createMinor(int row, int col) {
       if (col == j) {
         offset_col = 1;
       }
-      res._matrix[i][j] = this->_matrix[i + offset_row][j + offset_col];
+      res.rowPtr(i)[j] = this->rowPtr(i + offset_row)[j + offset_col];
     }
   }
   return res;
 }
 
-S21Matrix S21Matrix::CalcComplements() {
+S21Matrix S21Matrix::CalcComplements() const {
   if (this->_rows != this->_cols) {
     throw std::invalid_argument("Matrix is not sqared");
   }
@@ -159,7 +440,7 @@ S21Matrix S21Matrix::CalcComplements() {
   for (int i = 0; i < this->_rows; ++i) {
     for (int j = 0; j < this->_cols; ++j) {
       minor = this->createMinor(i, j);
-      res._matrix[i][j] = (((i + j) % 2) ? -1 : 1) * minor.Determinant();
+      res.rowPtr(i)[j] = (((i + j) % 2) ? -1 : 1) * minor.Determinant();
     }
   }
   return res;
@@ -169,17 +450,22 @@ S21Matrix S21Matrix::CalcComplements() {
 // void S21Matrix::printMatrix() {
 //   for (int i = 0; i < this->_rows; ++i) {
 //     for (int j = 0; j < this->_cols; ++j) {
-//       std::cout << this->_matrix[i][j] << ' ';
+//       std::cout << this->rowPtr(i)[j] << ' ';
 //     }
 //     std::cout << std::endl;
 //   }
 // }
 // extra
 
-S21Matrix S21Matrix::InverseMatrix() {
+S21Matrix S21Matrix::InverseMatrix() const {
   if (this->_rows != this->_cols) {
     throw std::invalid_argument("Matrix is not sqared");
   }
+#ifdef S21_USE_BLAS
+  if (getBackend() == S21Backend::kBlas) {
+    return blasInverse();
+  }
+#endif
   double det = this->Determinant();
   if (det == 0) {
     throw std::logic_error("Determinant = 0");
@@ -194,27 +480,44 @@ S21Matrix S21Matrix::InverseMatrix() {
   return result;
 }
 
-double& S21Matrix::operator()(int row, int col) {
-  if (row >= this->_rows || col >= this->_cols) {
-    throw std::out_of_range("Incorrect input, index is out of range");
+S21Matrix& S21Matrix::operator=(const S21Matrix& o) {
+  if (this == &o) {
+    return *this;
   }
-  return this->_matrix[row][col];
+  if (_owner && o._refs) {
+    S21Matrix copy(o);
+    return *this = std::move(copy);  // the move marks the change
+  }
+  makeUnique();
+  if (_rows != o._rows || _cols != o._cols) {
+    deleteMatrix();
+    this->_rows = o._rows;
+    this->_cols = o._cols;
+    createMatrix();
+  }
+  copyElements(o);
+  return *this;
 }
 
-S21Matrix& S21Matrix::operator=(const S21Matrix& o) {
-  deleteMatrix();
-  this->_rows = o._rows;
-  this->_cols = o._cols;
-  createMatrix();
-  for (int i = 0; i < this->_rows; ++i) {
-    for (int j = 0; j < this->_cols; ++j) {
-      this->_matrix[i][j] = o._matrix[i][j];
-    }
+S21Matrix& S21Matrix::operator=(S21Matrix&& o) {
+  if (this != &o) {
+    deleteMatrix();
+    std::swap(_rows, o._rows);
+    std::swap(_cols, o._cols);
+    std::swap(_stride, o._stride);
+    std::swap(_matrix, o._matrix);
+    std::swap(_owner, o._owner);
+    std::swap(_refs, o._refs);
+    ++_version;
+    ++o._version;
+    o._rows = 0;
+    o._cols = 0;
+    o._stride = 0;
   }
   return *this;
 }
 
-S21Matrix S21Matrix::operator+(const S21Matrix& o) {
+S21Matrix S21Matrix::operator+(const S21Matrix& o) const {
   S21Matrix res(*this);
   res.SumMatrix(o);
   return res;
@@ -225,7 +528,7 @@ S21Matrix& S21Matrix::operator+=(const S21Matrix& o) {
   return *this;
 }
 
-S21Matrix S21Matrix::operator-(const S21Matrix& o) {
+S21Matrix S21Matrix::operator-(const S21Matrix& o) const {
   S21Matrix res(*this);
   res.SubMatrix(o);
   return res;
@@ -241,9 +544,12 @@ S21Matrix& S21Matrix::operator*=(const S21Matrix& o) {
   return *this;
 }
 
-S21Matrix S21Matrix::operator*(const S21Matrix& o) {
-  S21Matrix res(*this);
-  res.MulMatrix(o);
+S21Matrix S21Matrix::operator*(const S21Matrix& o) const {
+  if (_cols != o._rows) {
+    throw std::invalid_argument("Wrong size of matrixes");
+  }
+  S21Matrix res(_rows, o._cols);
+  res.Gemm(S21Op::kNoTrans, S21Op::kNoTrans, 1, *this, o, 0);
   return res;
 }
 
@@ -252,24 +558,34 @@ S21Matrix& S21Matrix::operator*=(const double& num) {
   return *this;
 }
 
-S21Matrix S21Matrix::operator*(const double& num) {
+S21Matrix S21Matrix::operator*(const double& num) const {
   S21Matrix res(*this);
   res.MulNumber(num);
   return res;
 }
 
-double* S21Matrix::operator[](int row) const {
-  if (row >= _rows)
-    throw std::out_of_range("Incorrect input, index is out of range");
-
-  return _matrix[row];
+bool S21Matrix::operator==(const S21Matrix& o) const {
+  return this->EqMatrix(o);
 }
 
-bool S21Matrix::operator==(const S21Matrix& o) { return this->EqMatrix(o); }
+void S21Matrix::setCopyOnWrite(bool enabled) { copyOnWrite = enabled; }
 
-int S21Matrix::getRow() { return this->_rows; }
+bool S21Matrix::getCopyOnWrite() { return copyOnWrite; }
 
-int S21Matrix::getCol() { return this->_cols; }
+bool S21Matrix::isShared() const {
+  return _refs && _refs->load(std::memory_order_acquire) > 1;
+}
+
+void S21Matrix::setBackend(S21Backend value) {
+#ifndef S21_USE_BLAS
+  if (value == S21Backend::kBlas) {
+    throw std::logic_error("Library is built without BLAS backend");
+  }
+#endif
+  backend = value;
+}
+
+S21Backend S21Matrix::getBackend() { return backend; }
 
 void S21Matrix::setRow(int row) {
   if (row <= 0) {
@@ -277,11 +593,9 @@ void S21Matrix::setRow(int row) {
   }
   S21Matrix res(row, _cols);
   for (int i = 0; i < res._rows && i < this->_rows; ++i) {
-    for (int j = 0; j < res._cols; ++j) {
-      res(i, j) = this->_matrix[i][j];
-    }
+    std::copy(rowPtr(i), rowPtr(i) + _cols, res.rowPtr(i));
   }
-  *this = res;
+  *this = std::move(res);
 }
 
 void S21Matrix::setCol(int col) {
@@ -289,10 +603,9 @@ void S21Matrix::setCol(int col) {
     throw std::length_error("Wrong size of matrix");
   }
   S21Matrix res(_rows, col);
+  const int keep = std::min(col, _cols);
   for (int i = 0; i < res._rows; ++i) {
-    for (int j = 0; j < res._cols && j < this->_cols; ++j) {
-      res(i, j) = this->_matrix[i][j];
-    }
+    std::copy(rowPtr(i), rowPtr(i) + keep, res.rowPtr(i));
   }
-  *this = res;
+  *this = std::move(res);
 }
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include "s21_matrix_async.h"
+
+#include <atomic>
+#include <optional>
+
+struct S21AsyncMatrix::State {
+  std::mutex mutex;
+  bool ready = false;
+  std::vector<std::function<void()>> continuations;  // run once ready
+  std::promise<void> promise;
+  std::shared_future<void> signal = promise.get_future().share();
+
+  std::optional<S21Matrix> value;
+  const S21Matrix* result = nullptr;  // value or a borrowed matrix
+  std::exception_ptr error;
+
+  // operation waiting for its operands, released once it has run
+  std::vector<std::shared_ptr<State>> deps;
+  Operation op;
+  std::atomic<int> pending{0};
+
+  void complete(std::exception_ptr err) {
+    std::vector<std::function<void()>> next;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      error = err;
+      ready = true;
+      next.swap(continuations);
+    }
+    if (err) {
+      promise.set_exception(err);
+    } else {
+      promise.set_value();
+    }
+    for (std::function<void()>& fn : next) {
+      fn();
+    }
+  }
+
+  void onReady(std::function<void()> fn) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!ready) {
+        continuations.push_back(std::move(fn));
+        return;
+      }
+    }
+    fn();
+  }
+};
+
+S21AsyncMatrix::S21AsyncMatrix(std::shared_ptr<State> state)
+    : _state(std::move(state)) {}
+
+S21AsyncMatrix::S21AsyncMatrix(S21Matrix value)
+    : _state(std::make_shared<State>()) {
+  _state->value.emplace(std::move(value));
+  _state->result = &*_state->value;
+  _state->complete(nullptr);
+}
+
+S21AsyncMatrix S21AsyncMatrix::Borrow(const S21Matrix& value) {
+  std::shared_ptr<State> state = std::make_shared<State>();
+  state->result = &value;
+  state->complete(nullptr);
+  return S21AsyncMatrix(state);
+}
+
+S21AsyncMatrix S21AsyncMatrix::Then(const std::vector<S21AsyncMatrix>& deps,
+                                    Operation op, S21Executor& executor) {
+  std::shared_ptr<State> node = std::make_shared<State>();
+  node->op = std::move(op);
+  node->pending = static_cast<int>(deps.size()) + 1;
+  for (const S21AsyncMatrix& dep : deps) {
+    node->deps.push_back(dep._state);
+  }
+  S21Executor* ex = &executor;
+  for (const S21AsyncMatrix& dep : deps) {
+    dep._state->onReady([node, ex] {
+      if (--node->pending == 0) schedule(node, ex);
+    });
+  }
+  if (--node->pending == 0) {
+    schedule(node, ex);
+  }
+  return S21AsyncMatrix(node);
+}
+
+void S21AsyncMatrix::schedule(std::shared_ptr<State> node,
+                              S21Executor* executor) {
+  executor->Submit([node] {
+    std::exception_ptr err;
+    Operands operands;
+    for (const std::shared_ptr<State>& dep : node->deps) {
+      if (dep->error) {
+        err = dep->error;
+        break;
+      }
+      operands.push_back(dep->result);
+    }
+    if (!err) {
+      try {
+        node->value.emplace(node->op(operands));
+        node->result = &*node->value;
+      } catch (...) {
+        err = std::current_exception();
+      }
+    }
+    node->deps.clear();
+    node->op = nullptr;
+    node->complete(err);
+  });
+}
+
+S21AsyncMatrix S21AsyncMatrix::Sum(const S21AsyncMatrix& o,
+                                   S21Executor& executor) const {
+  return Then(
+      {*this, o},
+      [](const Operands& m) {
+        S21Matrix res(*m[0]);
+        res.SumMatrix(*m[1]);
+        return res;
+      },
+      executor);
+}
+
+S21AsyncMatrix S21AsyncMatrix::Sub(const S21AsyncMatrix& o,
+                                   S21Executor& executor) const {
+  return Then(
+      {*this, o},
+      [](const Operands& m) {
+        S21Matrix res(*m[0]);
+        res.SubMatrix(*m[1]);
+        return res;
+      },
+      executor);
+}
+
+S21AsyncMatrix S21AsyncMatrix::Mul(const S21AsyncMatrix& o,
+                                   S21Executor& executor) const {
+  return Then(
+      {*this, o}, [](const Operands& m) { return *m[0] * *m[1]; }, executor);
+}
+
+S21AsyncMatrix S21AsyncMatrix::MulNumber(double num,
+                                         S21Executor& executor) const {
+  return Then(
+      {*this},
+      [num](const Operands& m) {
+        S21Matrix res(*m[0]);
+        res.MulNumber(num);
+        return res;
+      },
+      executor);
+}
+
+S21AsyncMatrix S21AsyncMatrix::Transpose(S21Executor& executor) const {
+  return Then(
+      {*this}, [](const Operands& m) { return m[0]->Transpose(); }, executor);
+}
+
+S21AsyncMatrix S21AsyncMatrix::Inverse(S21Executor& executor) const {
+  return Then(
+      {*this}, [](const Operands& m) { return m[0]->InverseMatrix(); },
+      executor);
+}
+
+bool S21AsyncMatrix::isReady() const {
+  return _state->signal.wait_for(std::chrono::seconds(0)) ==
+         std::future_status::ready;
+}
+
+void S21AsyncMatrix::wait() const { _state->signal.wait(); }
+
+const S21Matrix& S21AsyncMatrix::get() const {
+  _state->signal.get();
+  return *_state->result;
+}
+
+std::shared_future<void> S21AsyncMatrix::done() const { return _state->signal; }
@@ -0,0 +1,56 @@
+#ifndef __S21MATRIX_ASYNC_H__
+#define __S21MATRIX_ASYNC_H__
+
+#include <exception>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "s21_executor.h"
+#include "s21_matrix_oop.h"
+
+// handle to a matrix that is being computed on an executor. Operations on
+// handles return new handles at once: each one is queued when all of its
+// operands are ready, so a whole DAG can be submitted without blocking.
+// Handles are cheap to copy and share the same result.
+class S21AsyncMatrix {
+ public:
+  using Operands = std::vector<const S21Matrix*>;
+  using Operation = std::function<S21Matrix(const Operands&)>;
+
+ private:
+  struct State;
+  std::shared_ptr<State> _state;
+
+  explicit S21AsyncMatrix(std::shared_ptr<State> state);
+  static void schedule(std::shared_ptr<State> node, S21Executor* executor);
+
+ public:
+  S21AsyncMatrix(S21Matrix value);  // an already available result
+  // wraps a matrix without copying it; it must outlive every handle using it
+  static S21AsyncMatrix Borrow(const S21Matrix& value);
+  // runs op on the executor once every dependency is ready; a failed
+  // dependency fails the result with the same exception
+  static S21AsyncMatrix Then(const std::vector<S21AsyncMatrix>& deps,
+                             Operation op,
+                             S21Executor& executor = S21Executor::Default());
+
+  S21AsyncMatrix Sum(const S21AsyncMatrix& o,
+                     S21Executor& executor = S21Executor::Default()) const;
+  S21AsyncMatrix Sub(const S21AsyncMatrix& o,
+                     S21Executor& executor = S21Executor::Default()) const;
+  S21AsyncMatrix Mul(const S21AsyncMatrix& o,
+                     S21Executor& executor = S21Executor::Default()) const;
+  S21AsyncMatrix MulNumber(double num,
+                           S21Executor& executor = S21Executor::Default()) const;
+  S21AsyncMatrix Transpose(S21Executor& executor = S21Executor::Default()) const;
+  S21AsyncMatrix Inverse(S21Executor& executor = S21Executor::Default()) const;
+
+  bool isReady() const;
+  void wait() const;
+  const S21Matrix& get() const;  // waits, rethrows the operation's exception
+  // becomes ready together with the result, for use with other futures
+  std::shared_future<void> done() const;
+};
+
+#endif
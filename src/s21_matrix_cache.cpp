@@ -0,0 +1,191 @@
+#include "s21_matrix_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// identity-keyed caches, told when a cached matrix is destroyed; taken
+// before any cache mutex, never while holding one
+std::mutex registryMutex;
+std::vector<S21MatrixCache*> registry;
+
+// FNV-1a style over the size and every element taken as one 8-byte word.
+// The multiply only carries upwards, so each step folds the high half back
+// down; both steps are invertible, so matrices that differ in a single
+// element never collide.
+uint64_t contentHash(const S21Matrix& m) {
+  const uint64_t kPrime = 1099511628211ULL;
+  uint64_t hash = 14695981039346656037ULL;
+  auto mix = [&hash](uint64_t word) {
+    hash = (hash ^ word) * kPrime;
+    hash ^= hash >> 32;
+  };
+  const int rows = m.getRow(), cols = m.getCol();
+  mix(static_cast<uint64_t>(rows) << 32 | static_cast<uint32_t>(cols));
+  for (int i = 0; i < rows; ++i) {
+    const double* x = m.data() + static_cast<size_t>(i) * m.stride();
+    for (int j = 0; j < cols; ++j) {
+      uint64_t word;
+      std::memcpy(&word, &x[j], sizeof(word));
+      mix(word);
+    }
+  }
+  return hash;
+}
+
+// bitwise equal size and elements
+bool sameContent(const S21Matrix& a, const S21Matrix& b) {
+  if (a.getRow() != b.getRow() || a.getCol() != b.getCol()) {
+    return false;
+  }
+  for (int i = 0; i < a.getRow(); ++i) {
+    if (std::memcmp(a.data() + static_cast<size_t>(i) * a.stride(),
+                    b.data() + static_cast<size_t>(i) * b.stride(),
+                    a.getCol() * sizeof(double)) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+S21MatrixCache::S21MatrixCache(size_t capacity, S21CacheKey mode)
+    : _capacity(std::max<size_t>(capacity, 1)),
+      _mode(mode),
+      _hits(0),
+      _misses(0) {
+  if (_mode == S21CacheKey::kIdentity) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    registry.push_back(this);
+  }
+}
+
+S21MatrixCache::~S21MatrixCache() {
+  if (_mode == S21CacheKey::kIdentity) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    registry.erase(std::find(registry.begin(), registry.end(), this));
+  }
+}
+
+void S21Matrix::forgetCached(uint64_t id) {
+  // released after the locks: the results may hold cached matrices whose
+  // destructors come back here
+  std::vector<std::shared_ptr<const S21MatrixCache::Entry>> dropped;
+  std::lock_guard<std::mutex> lock(registryMutex);
+  for (S21MatrixCache* cache : registry) {
+    std::unique_lock<std::shared_mutex> write(cache->_mutex);
+    dropped.push_back(cache->erase(id));
+  }
+}
+
+S21MatrixCache::Key S21MatrixCache::keyOf(const S21Matrix& m) const {
+  return _mode == S21CacheKey::kIdentity ? m._id : contentHash(m);
+}
+
+bool S21MatrixCache::matches(const Entry& entry, const S21Matrix& m) const {
+  return _mode == S21CacheKey::kIdentity
+             ? entry.version == m._version
+             : sameContent(*entry.source, m);
+}
+
+template <class T, class F>
+std::shared_ptr<const T> S21MatrixCache::lookup(
+    const S21Matrix& m, std::shared_ptr<const T> Entry::*slot, F compute) {
+  const Key key = keyOf(m);
+  std::shared_ptr<const T> value;
+  {
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    auto it = _slots.find(key);
+    if (it != _slots.end() && matches(*it->second.entry, m)) {
+      value = (*it->second.entry).*slot;
+    }
+  }
+  if (value) {
+    ++_hits;
+    return value;
+  }
+  ++_misses;
+  // computed without the lock, so other lookups are not held up
+  value = std::make_shared<const T>(compute());
+
+  std::shared_ptr<const Entry> dropped;  // released after the lock
+  std::unique_lock<std::shared_mutex> lock(_mutex);
+  auto it = _slots.find(key);
+  std::shared_ptr<Entry> entry = std::make_shared<Entry>();
+  if (it != _slots.end()) {
+    if (matches(*it->second.entry, m)) {
+      *entry = *it->second.entry;
+    }
+    dropped = erase(key);
+  } else if (_slots.size() >= _capacity) {
+    dropped = erase(_order.front());
+  }
+  entry->version = m._version;
+  if (_mode == S21CacheKey::kContent && !entry->source) {
+    entry->source = std::make_shared<const S21Matrix>(m);
+  }
+  (*entry).*slot = value;
+  _slots[key] = {entry, _order.insert(_order.end(), key)};
+  if (_mode == S21CacheKey::kIdentity) {
+    m._cached = true;
+  }
+  return value;
+}
+
+std::shared_ptr<const S21MatrixCache::Entry> S21MatrixCache::erase(Key key) {
+  std::shared_ptr<const Entry> entry;
+  auto it = _slots.find(key);
+  if (it != _slots.end()) {
+    entry = std::move(it->second.entry);
+    _order.erase(it->second.position);
+    _slots.erase(it);
+  }
+  return entry;
+}
+
+double S21MatrixCache::Determinant(const S21Matrix& m) {
+  return *lookup(m, &Entry::determinant, [&m] { return m.Determinant(); });
+}
+
+std::shared_ptr<const S21Matrix> S21MatrixCache::InverseMatrix(
+    const S21Matrix& m) {
+  return lookup(m, &Entry::inverse, [&m] { return m.InverseMatrix(); });
+}
+
+std::shared_ptr<const S21EigenResult> S21MatrixCache::EigenSymmetric(
+    const S21Matrix& m) {
+  return lookup(m, &Entry::eigen, [&m] { return m.EigenSymmetric(); });
+}
+
+std::shared_ptr<const S21SvdResult> S21MatrixCache::Svd(const S21Matrix& m) {
+  return lookup(m, &Entry::svd, [&m] { return m.Svd(); });
+}
+
+void S21MatrixCache::Invalidate(const S21Matrix& m) {
+  const Key key = keyOf(m);
+  std::shared_ptr<const Entry> dropped;
+  std::unique_lock<std::shared_mutex> lock(_mutex);
+  dropped = erase(key);
+}
+
+void S21MatrixCache::Clear() {
+  std::unordered_map<Key, Slot> dropped;
+  std::unique_lock<std::shared_mutex> lock(_mutex);
+  dropped.swap(_slots);
+  _order.clear();
+}
+
+size_t S21MatrixCache::getSize() const {
+  std::shared_lock<std::shared_mutex> lock(_mutex);
+  return _slots.size();
+}
+
+S21CacheKey S21MatrixCache::getMode() const { return _mode; }
+
+uint64_t S21MatrixCache::getHits() const { return _hits; }
+
+uint64_t S21MatrixCache::getMisses() const { return _misses; }
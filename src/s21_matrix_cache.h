@@ -0,0 +1,100 @@
+#ifndef __S21MATRIX_CACHE_H__
+#define __S21MATRIX_CACHE_H__
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "s21_matrix_oop.h"
+
+// how S21MatrixCache recognises a matrix
+enum class S21CacheKey {
+  // by object: a result is reused only for the same S21Matrix while it has
+  // not been modified; copies are separate keys. The entries of a matrix
+  // are dropped when it is destroyed.
+  kIdentity,
+  // by content: a hash of the size and the elements, confirmed by an exact
+  // comparison with a copy kept in the entry, so equal copies share results.
+  // Every lookup reads the whole matrix, and entries outlive their matrices
+  // until they are evicted.
+  kContent
+};
+
+// memoises expensive results derived from matrices. With kIdentity a
+// non-const accessor such as operator() counts as a modification even when
+// it only reads, so read through const references to keep the entries.
+// The modification is counted when the accessor is called: writes through
+// a pointer or span from data() or row() kept across a lookup, and writes
+// to the memory behind a Wrap view, are not seen. Call
+// S21Matrix::MarkModified after them (or Invalidate for this cache only).
+//
+// Results are returned as shared immutable objects, so a hit copies
+// nothing. All methods may be called concurrently. Lookups share a read
+// lock; two threads missing on the same entry may both compute it. The
+// least recently computed entries are dropped once more than capacity
+// matrices are cached.
+class S21MatrixCache {
+ private:
+  using Key = uint64_t;  // S21Matrix::_id, or the content hash
+
+  // results for one version or content of a matrix; published entries are
+  // never changed, storing a result replaces the whole entry
+  struct Entry {
+    uint64_t version = 0;
+    std::shared_ptr<const S21Matrix> source;  // kContent only
+    std::shared_ptr<const double> determinant;
+    std::shared_ptr<const S21Matrix> inverse;
+    std::shared_ptr<const S21EigenResult> eigen;
+    std::shared_ptr<const S21SvdResult> svd;
+  };
+  struct Slot {
+    std::shared_ptr<const Entry> entry;
+    std::list<Key>::iterator position;  // in _order
+  };
+
+  size_t _capacity;
+  S21CacheKey _mode;
+  std::unordered_map<Key, Slot> _slots;
+  std::list<Key> _order;  // least recently stored first
+  mutable std::shared_mutex _mutex;
+  std::atomic<uint64_t> _hits, _misses;
+
+  Key keyOf(const S21Matrix& m) const;
+  // the entry describes the current state of m
+  bool matches(const Entry& entry, const S21Matrix& m) const;
+  // the cached result in slot for the current state of m, computed and
+  // stored on a miss
+  template <class T, class F>
+  std::shared_ptr<const T> lookup(const S21Matrix& m,
+                                  std::shared_ptr<const T> Entry::*slot,
+                                  F compute);
+  // removes an entry with the write lock held; the caller releases it
+  // after unlocking, since destroying results may destroy cached matrices
+  std::shared_ptr<const Entry> erase(Key key);
+
+  friend class S21Matrix;  // drops the entries of destroyed matrices
+
+ public:
+  explicit S21MatrixCache(size_t capacity = 1024,
+                          S21CacheKey mode = S21CacheKey::kIdentity);
+  S21MatrixCache(const S21MatrixCache&) = delete;
+  S21MatrixCache& operator=(const S21MatrixCache&) = delete;
+  ~S21MatrixCache();
+
+  double Determinant(const S21Matrix& m);
+  std::shared_ptr<const S21Matrix> InverseMatrix(const S21Matrix& m);
+  std::shared_ptr<const S21EigenResult> EigenSymmetric(const S21Matrix& m);
+  std::shared_ptr<const S21SvdResult> Svd(const S21Matrix& m);
+
+  void Invalidate(const S21Matrix& m);
+  void Clear();
+  size_t getSize() const;
+  S21CacheKey getMode() const;
+  uint64_t getHits() const;
+  uint64_t getMisses() const;
+};
+
+#endif
@@ -0,0 +1,474 @@
+#include <cfloat>
+#include <numeric>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+namespace {
+
+const int kMaxQlIterations = 60;
+const int kMaxJacobiSweeps = 60;
+const int kInverseIterations = 3;
+
+// offset of element (i, j) in a row-major buffer with n columns, in size_t
+// so that n * n past INT_MAX does not overflow
+inline size_t offset(int i, int j, int n) {
+  return static_cast<size_t>(i) * n + j;
+}
+
+// Householder reduction of a symmetric n x n row-major matrix to tridiagonal
+// form T = Q^T A Q. The lower triangle of a is read; on return d and e hold
+// the diagonal and the subdiagonal (e[n - 1] = 0), the reflector of step k
+// is v = (1, a[k][k + 2], ..., a[k][n - 1]) acting on rows k + 1.. and its
+// scale is beta[k].
+void tridiagonalize(std::vector<double>& a, int n, std::vector<double>& d,
+                    std::vector<double>& e, std::vector<double>& beta) {
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < i; ++j) a[offset(j, i, n)] = a[offset(i, j, n)];
+  }
+  d.assign(n, 0);
+  e.assign(n, 0);
+  beta.assign(n, 0);
+  std::vector<double> v(n), p(n);
+  for (int k = 0; k + 2 < n; ++k) {
+    const int len = n - k - 1;
+    double tail = 0;
+    for (int i = k + 2; i < n; ++i) {
+      tail += a[offset(i, k, n)] * a[offset(i, k, n)];
+    }
+    double x0 = a[offset(k + 1, k, n)];
+    if (tail == 0) {
+      e[k] = x0;
+      continue;
+    }
+    double alpha = -std::copysign(std::sqrt(x0 * x0 + tail), x0);
+    double v0 = x0 - alpha;
+    v[0] = 1;
+    for (int i = 1; i < len; ++i) v[i] = a[offset(k + 1 + i, k, n)] / v0;
+    beta[k] = 2 / (1 + tail / (v0 * v0));
+    e[k] = alpha;
+    // B -= v w^T + w v^T with p = beta B v and w = p - (beta p.v / 2) v
+    double pv = 0;
+    for (int i = 0; i < len; ++i) {
+      const double* row = &a[offset(k + 1 + i, k + 1, n)];
+      double s = 0;
+      for (int j = 0; j < len; ++j) s += row[j] * v[j];
+      p[i] = beta[k] * s;
+      pv += p[i] * v[i];
+    }
+    double half = beta[k] * pv / 2;
+    for (int i = 0; i < len; ++i) p[i] -= half * v[i];
+    for (int i = 0; i < len; ++i) {
+      double* row = &a[offset(k + 1 + i, k + 1, n)];
+      for (int j = 0; j < len; ++j) row[j] -= v[i] * p[j] + p[i] * v[j];
+    }
+    for (int i = 1; i < len; ++i) a[offset(k, k + 1 + i, n)] = v[i];
+  }
+  for (int i = 0; i < n; ++i) d[i] = a[offset(i, i, n)];
+  if (n > 1) e[n - 2] = a[offset(n - 1, n - 2, n)];
+}
+
+// applies the reflector of step k to the length-n vector x
+void applyReflector(const std::vector<double>& a, int n,
+                    const std::vector<double>& beta, int k, double* x) {
+  if (beta[k] == 0) return;
+  const double* v = &a[offset(k, 0, n)];
+  double s = x[k + 1];
+  for (int i = k + 2; i < n; ++i) s += v[i] * x[i];
+  s *= beta[k];
+  x[k + 1] -= s;
+  for (int i = k + 2; i < n; ++i) x[i] -= s * v[i];
+}
+
+// builds Q^T of the reduction; row i of the result is column i of Q
+std::vector<double> reflectorsTransposed(const std::vector<double>& a, int n,
+                                         const std::vector<double>& beta) {
+  std::vector<double> qt(static_cast<size_t>(n) * n, 0);
+  for (int i = 0; i < n; ++i) qt[offset(i, i, n)] = 1;
+  std::vector<double> w(n);
+  for (int k = 0; k + 2 < n; ++k) {
+    if (beta[k] == 0) continue;
+    const double* v = &a[offset(k, 0, n)];
+    // rows k + 1.. of Q^T: R -= beta v (v^T R)
+    std::fill(w.begin(), w.end(), 0);
+    for (int i = k + 1; i < n; ++i) {
+      double vi = i == k + 1 ? 1 : v[i];
+      const double* row = &qt[offset(i, 0, n)];
+      for (int j = 0; j < n; ++j) w[j] += vi * row[j];
+    }
+    for (int i = k + 1; i < n; ++i) {
+      double vi = beta[k] * (i == k + 1 ? 1 : v[i]);
+      double* row = &qt[offset(i, 0, n)];
+      for (int j = 0; j < n; ++j) row[j] -= vi * w[j];
+    }
+  }
+  return qt;
+}
+
+// implicit QL iteration on the symmetric tridiagonal (d, e). When zt is
+// given, its rows are rotated along, so rows that start as Q^T end up as
+// the eigenvectors.
+void tridiagonalQl(std::vector<double>& d, std::vector<double>& e, int n,
+                   std::vector<double>* zt) {
+  for (int l = 0; l < n; ++l) {
+    int iter = 0, m;
+    do {
+      for (m = l; m < n - 1; ++m) {
+        double dd = std::fabs(d[m]) + std::fabs(d[m + 1]);
+        if (std::fabs(e[m]) <= DBL_EPSILON * dd) break;
+      }
+      if (m != l) {
+        if (iter++ == kMaxQlIterations) {
+          throw std::runtime_error("Eigenvalue iteration did not converge");
+        }
+        double g = (d[l + 1] - d[l]) / (2 * e[l]);
+        double r = std::hypot(g, 1.0);
+        g = d[m] - d[l] + e[l] / (g + std::copysign(r, g));
+        double s = 1, c = 1, p = 0;
+        int i;
+        for (i = m - 1; i >= l; --i) {
+          double f = s * e[i], b = c * e[i];
+          e[i + 1] = (r = std::hypot(f, g));
+          if (r == 0) {
+            d[i + 1] -= p;
+            e[m] = 0;
+            break;
+          }
+          s = f / r;
+          c = g / r;
+          g = d[i + 1] - p;
+          r = (d[i] - g) * s + 2 * c * b;
+          d[i + 1] = g + (p = s * r);
+          g = c * r - b;
+          if (zt) {
+            double* zi = &(*zt)[offset(i, 0, n)];
+            double* zn = zi + n;
+            for (int k = 0; k < n; ++k) {
+              double t = zn[k];
+              zn[k] = s * zi[k] + c * t;
+              zi[k] = c * zi[k] - s * t;
+            }
+          }
+        }
+        if (r == 0 && i >= l) continue;
+        d[l] -= p;
+        e[l] = g;
+        e[m] = 0;
+      }
+    } while (m != l);
+  }
+}
+
+// eigenvector of the tridiagonal (d, e) for eigenvalue lambda by inverse
+// iteration, kept orthogonal to the vectors in done
+std::vector<double> tridiagonalEigenvector(
+    const std::vector<double>& d, const std::vector<double>& e, int n,
+    double lambda, double norm, const std::vector<std::vector<double>>& done) {
+  // (T - lambda I) = LU with partial pivoting, LAPACK dgttrf layout
+  std::vector<double> dl(e.begin(), e.begin() + n - 1), dm(n), du(dl);
+  std::vector<double> du2(n, 0);
+  std::vector<bool> swapped(n, false);
+  for (int i = 0; i < n; ++i) dm[i] = d[i] - lambda;
+  const double tiny = DBL_EPSILON * std::max(norm, DBL_MIN);
+  for (int i = 0; i + 1 < n; ++i) {
+    if (std::fabs(dm[i]) >= std::fabs(dl[i])) {
+      if (dm[i] == 0) dm[i] = tiny;
+      double fact = dl[i] / dm[i];
+      dl[i] = fact;
+      dm[i + 1] -= fact * du[i];
+    } else {
+      double fact = dm[i] / dl[i];
+      dm[i] = dl[i];
+      dl[i] = fact;
+      double t = du[i];
+      du[i] = dm[i + 1];
+      dm[i + 1] = t - fact * dm[i + 1];
+      if (i + 2 < n) {
+        du2[i] = du[i + 1];
+        du[i + 1] = -fact * du[i + 1];
+      }
+      swapped[i] = true;
+    }
+  }
+  if (dm[n - 1] == 0) dm[n - 1] = tiny;
+
+  std::vector<double> x(n);
+  for (int i = 0; i < n; ++i) x[i] = 1 + 0.1 * ((i % 13) * 7919 % 13);
+  for (int it = 0; it < kInverseIterations; ++it) {
+    for (int i = 0; i + 1 < n; ++i) {
+      if (swapped[i]) {
+        double t = x[i];
+        x[i] = x[i + 1];
+        x[i + 1] = t - dl[i] * x[i];
+      } else {
+        x[i + 1] -= dl[i] * x[i];
+      }
+    }
+    for (int i = n - 1; i >= 0; --i) {
+      double s = x[i];
+      if (i + 1 < n) s -= du[i] * x[i + 1];
+      if (i + 2 < n) s -= du2[i] * x[i + 2];
+      x[i] = s / dm[i];
+    }
+    for (const std::vector<double>& q : done) {
+      double dot = std::inner_product(x.begin(), x.end(), q.begin(), 0.0);
+      for (int i = 0; i < n; ++i) x[i] -= dot * q[i];
+    }
+    double len =
+        std::sqrt(std::inner_product(x.begin(), x.end(), x.begin(), 0.0));
+    if (len == 0) {
+      throw std::runtime_error("Eigenvector iteration did not converge");
+    }
+    for (double& xi : x) xi /= len;
+  }
+  return x;
+}
+
+// order of indices that sorts values in descending order
+std::vector<int> descendingOrder(const std::vector<double>& values) {
+  std::vector<int> order(values.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](int l, int r) { return values[l] > values[r]; });
+  return order;
+}
+
+// replaces the rows of qt (count x m, count <= m) that are not filled by
+// unit vectors orthogonal to every other row, so a basis that lost the
+// directions of zero singular values is orthonormal again. Each is the
+// first unit vector e_i that keeps more than half its length after two
+// Gram-Schmidt passes, or the one that keeps most if none does.
+void completeOrthonormal(std::vector<double>& qt, int count, int m,
+                         std::vector<bool> filled) {
+  std::vector<double> x(m);
+  int candidate = 0;
+  for (int j = 0; j < count; ++j) {
+    if (filled[j]) continue;
+    double* row = &qt[offset(j, 0, m)];
+    double best = 0;
+    for (int tries = 0; tries < m && best <= 0.5; ++tries) {
+      std::fill(x.begin(), x.end(), 0.0);
+      x[candidate] = 1;
+      candidate = (candidate + 1) % m;
+      for (int pass = 0; pass < 2; ++pass) {
+        for (int r = 0; r < count; ++r) {
+          if (!filled[r]) continue;
+          const double* q = &qt[offset(r, 0, m)];
+          double dot = std::inner_product(x.begin(), x.end(), q, 0.0);
+          for (int i = 0; i < m; ++i) x[i] -= dot * q[i];
+        }
+      }
+      double len =
+          std::sqrt(std::inner_product(x.begin(), x.end(), x.begin(), 0.0));
+      if (len > best) {
+        best = len;
+        std::copy(x.begin(), x.end(), row);
+      }
+    }
+    for (int i = 0; i < m; ++i) row[i] /= best;
+    filled[j] = true;
+  }
+}
+
+}  // namespace
+
+S21EigenResult S21Matrix::EigenSymmetric(bool vectors) const {
+  if (_rows != _cols || _rows == 0) {
+    throw std::invalid_argument("Matrix is not sqared");
+  }
+  const int n = _rows;
+  std::vector<double> a = packed<double>(), d, e, beta;
+  tridiagonalize(a, n, d, e, beta);
+  std::vector<double> zt;
+  if (vectors) zt = reflectorsTransposed(a, n, beta);
+  tridiagonalQl(d, e, n, vectors ? &zt : nullptr);
+
+  std::vector<int> order = descendingOrder(d);
+  S21EigenResult res{S21Matrix(n, 1), vectors ? S21Matrix(n, n) : S21Matrix()};
+  for (int j = 0; j < n; ++j) {
+    res.values._matrix[j] = d[order[j]];
+    if (vectors) {
+      const double* z = &zt[offset(order[j], 0, n)];
+      for (int i = 0; i < n; ++i) res.vectors.rowPtr(i)[j] = z[i];
+    }
+  }
+  return res;
+}
+
+S21EigenResult S21Matrix::EigenSymmetricTopK(int k) const {
+  if (_rows != _cols || _rows == 0) {
+    throw std::invalid_argument("Matrix is not sqared");
+  }
+  if (k <= 0 || k > _rows) {
+    throw std::invalid_argument("Wrong number of eigenpairs");
+  }
+  const int n = _rows;
+  std::vector<double> a = packed<double>(), d, e, beta;
+  tridiagonalize(a, n, d, e, beta);
+  std::vector<double> values(d), off(e);
+  tridiagonalQl(values, off, n, nullptr);
+  std::vector<int> order = descendingOrder(values);
+
+  double norm = 0;
+  for (int i = 0; i < n; ++i) {
+    norm = std::max(norm, std::fabs(d[i]) + std::fabs(e[i]) +
+                              (i ? std::fabs(e[i - 1]) : 0));
+  }
+  S21EigenResult res{S21Matrix(k, 1), S21Matrix(n, k)};
+  std::vector<std::vector<double>> cluster;
+  for (int j = 0; j < k; ++j) {
+    double lambda = values[order[j]];
+    if (j && values[order[j - 1]] - lambda > 1e-3 * norm) cluster.clear();
+    std::vector<double> y =
+        tridiagonalEigenvector(d, e, n, lambda, norm, cluster);
+    cluster.push_back(y);
+    for (int step = n - 3; step >= 0; --step) {
+      applyReflector(a, n, beta, step, y.data());
+    }
+    res.values._matrix[j] = lambda;
+    for (int i = 0; i < n; ++i) res.vectors.rowPtr(i)[j] = y[i];
+  }
+  return res;
+}
+
+S21SvdResult S21Matrix::Svd() const {
+  if (_rows == 0) {
+    throw std::invalid_argument("Wrong size of matrix");
+  }
+  // one-sided Jacobi orthogonalises the columns of the taller orientation;
+  // they are kept as rows of ut so every rotation runs over contiguous memory
+  const bool wide = _rows < _cols;
+  const int m = wide ? _cols : _rows, n = wide ? _rows : _cols;
+  std::vector<double> ut(static_cast<size_t>(n) * m);
+  std::vector<double> vt(static_cast<size_t>(n) * n, 0);
+  for (int i = 0; i < _rows; ++i) {
+    for (int j = 0; j < _cols; ++j) {
+      if (wide) {
+        ut[offset(i, j, m)] = rowPtr(i)[j];
+      } else {
+        ut[offset(j, i, m)] = rowPtr(i)[j];
+      }
+    }
+  }
+  for (int i = 0; i < n; ++i) vt[offset(i, i, n)] = 1;
+
+  bool rotated = true;
+  for (int sweep = 0; rotated; ++sweep) {
+    if (sweep == kMaxJacobiSweeps) {
+      throw std::runtime_error("SVD iteration did not converge");
+    }
+    rotated = false;
+    for (int p = 0; p < n - 1; ++p) {
+      for (int q = p + 1; q < n; ++q) {
+        double* up = &ut[offset(p, 0, m)];
+        double* uq = &ut[offset(q, 0, m)];
+        double alpha = 0, beta = 0, gamma = 0;
+        for (int i = 0; i < m; ++i) {
+          alpha += up[i] * up[i];
+          beta += uq[i] * uq[i];
+          gamma += up[i] * uq[i];
+        }
+        if (std::fabs(gamma) <= DBL_EPSILON * std::sqrt(alpha * beta)) {
+          continue;
+        }
+        rotated = true;
+        double zeta = (beta - alpha) / (2 * gamma);
+        double t = std::copysign(1.0, zeta) /
+                   (std::fabs(zeta) + std::sqrt(1 + zeta * zeta));
+        double c = 1 / std::sqrt(1 + t * t), s = c * t;
+        for (int i = 0; i < m; ++i) {
+          double x = up[i], y = uq[i];
+          up[i] = c * x - s * y;
+          uq[i] = s * x + c * y;
+        }
+        double* vp = &vt[offset(p, 0, n)];
+        double* vq = &vt[offset(q, 0, n)];
+        for (int i = 0; i < n; ++i) {
+          double x = vp[i], y = vq[i];
+          vp[i] = c * x - s * y;
+          vq[i] = s * x + c * y;
+        }
+      }
+    }
+  }
+
+  std::vector<double> sigma(n);
+  std::vector<bool> nonzero(n);
+  for (int j = 0; j < n; ++j) {
+    double* u = &ut[offset(j, 0, m)];
+    sigma[j] = std::sqrt(std::inner_product(u, u + m, u, 0.0));
+    nonzero[j] = sigma[j] > 0;
+    if (nonzero[j]) {
+      for (int i = 0; i < m; ++i) u[i] /= sigma[j];
+    }
+  }
+  completeOrthonormal(ut, n, m, nonzero);
+  std::vector<int> order = descendingOrder(sigma);
+  S21SvdResult res{S21Matrix(_rows, n), S21Matrix(n, 1), S21Matrix(_cols, n)};
+  S21Matrix& left = wide ? res.v : res.u;
+  S21Matrix& right = wide ? res.u : res.v;
+  for (int j = 0; j < n; ++j) {
+    const double* u = &ut[offset(order[j], 0, m)];
+    const double* v = &vt[offset(order[j], 0, n)];
+    res.s._matrix[j] = sigma[order[j]];
+    for (int i = 0; i < m; ++i) left.rowPtr(i)[j] = u[i];
+    for (int i = 0; i < n; ++i) right.rowPtr(i)[j] = v[i];
+  }
+  return res;
+}
+
+S21SvdResult S21Matrix::SvdTopK(int k) const {
+  if (_rows == 0) {
+    throw std::invalid_argument("Wrong size of matrix");
+  }
+  if (k <= 0 || k > std::min(_rows, _cols)) {
+    throw std::invalid_argument("Wrong number of singular triplets");
+  }
+  // top-k eigenpairs of the smaller Gram matrix give the leading singular
+  // vectors of one side; the other side follows from one multiplication
+  const bool wide = _rows < _cols;
+  const int m = wide ? _cols : _rows, n = wide ? _rows : _cols;
+  S21Matrix gram(n, n);
+  for (int p = 0; p < n; ++p) {
+    for (int q = 0; q <= p; ++q) {
+      double s = 0;
+      if (wide) {
+        const double* x = rowPtr(p);
+        const double* y = rowPtr(q);
+        for (int i = 0; i < m; ++i) s += x[i] * y[i];
+      } else {
+        for (int i = 0; i < m; ++i) s += rowPtr(i)[p] * rowPtr(i)[q];
+      }
+      gram.rowPtr(p)[q] = s;
+    }
+  }
+  S21EigenResult eig = gram.EigenSymmetricTopK(k);
+
+  S21SvdResult res{S21Matrix(_rows, k), S21Matrix(k, 1), S21Matrix(_cols, k)};
+  S21Matrix& small = wide ? res.u : res.v;
+  S21Matrix& large = wide ? res.v : res.u;
+  // eigenvalues at the rounding level of the Gram matrix carry no direction,
+  // their columns of the large side are completed instead of divided out
+  const double noise = n * DBL_EPSILON * eig.values._matrix[0];
+  std::vector<double> lt(static_cast<size_t>(k) * m, 0);
+  std::vector<bool> resolved(k);
+  for (int j = 0; j < k; ++j) {
+    double sigma = std::sqrt(std::max(eig.values._matrix[j], 0.0));
+    res.s._matrix[j] = sigma;
+    resolved[j] = eig.values._matrix[j] > noise;
+    for (int i = 0; i < n; ++i) small.rowPtr(i)[j] = eig.vectors.rowPtr(i)[j];
+    if (!resolved[j]) continue;
+    for (int i = 0; i < m; ++i) {
+      double s = 0;
+      for (int p = 0; p < n; ++p) {
+        s += (wide ? rowPtr(p)[i] : rowPtr(i)[p]) * eig.vectors.rowPtr(p)[j];
+      }
+      lt[offset(j, i, m)] = s / sigma;
+    }
+  }
+  completeOrthonormal(lt, k, m, resolved);
+  for (int j = 0; j < k; ++j) {
+    for (int i = 0; i < m; ++i) large.rowPtr(i)[j] = lt[offset(j, i, m)];
+  }
+  return res;
+}
@@ -0,0 +1,37 @@
+#ifndef __S21MATRIX_EIGEN_H__
+#define __S21MATRIX_EIGEN_H__
+
+// zero-copy bridge to Eigen; include only where Eigen is available
+
+#include <Eigen/Core>
+
+#include "s21_matrix_oop.h"
+
+using S21EigenMatrix =
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+using S21EigenMap =
+    Eigen::Map<S21EigenMatrix, Eigen::Unaligned, Eigen::OuterStride<>>;
+using S21EigenConstMap =
+    Eigen::Map<const S21EigenMatrix, Eigen::Unaligned, Eigen::OuterStride<>>;
+// binds row-major matrices, maps and blocks without a copy; column-major
+// data would need a temporary and is rejected at compile time
+using S21EigenRef = Eigen::Ref<S21EigenMatrix, 0, Eigen::OuterStride<>>;
+
+inline S21EigenMap S21ToEigen(S21Matrix& m) {
+  return S21EigenMap(m.data(), m.getRow(), m.getCol(),
+                     Eigen::OuterStride<>(m.stride()));
+}
+
+inline S21EigenConstMap S21ToEigen(const S21Matrix& m) {
+  return S21EigenConstMap(m.data(), m.getRow(), m.getCol(),
+                          Eigen::OuterStride<>(m.stride()));
+}
+
+// non-owning S21Matrix over Eigen storage, see S21Matrix::Wrap
+inline S21Matrix S21FromEigen(S21EigenRef m) {
+  return S21Matrix::Wrap(m.data(), static_cast<int>(m.rows()),
+                         static_cast<int>(m.cols()),
+                         static_cast<int>(m.outerStride()));
+}
+
+#endif
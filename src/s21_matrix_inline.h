@@ -0,0 +1,43 @@
+#ifndef __S21MATRIX_INLINE_H__
+#define __S21MATRIX_INLINE_H__
+
+// the accessors on the hot path of element loops. Built with
+// S21_INLINE_ACCESSORS they are inline functions of s21_matrix_oop.h and
+// expand at every call site; otherwise s21_matrix.cpp compiles them once.
+// Library and users must agree on the setting.
+
+S21_MATRIX_INLINE double& S21Matrix::operator()(int row, int col) {
+  if (row >= this->_rows || col >= this->_cols) {
+    throw std::out_of_range("Incorrect input, index is out of range");
+  }
+  makeUnique();
+  return this->rowPtr(row)[col];
+}
+
+S21_MATRIX_INLINE const double& S21Matrix::operator()(int row, int col) const {
+  if (row >= this->_rows || col >= this->_cols) {
+    throw std::out_of_range("Incorrect input, index is out of range");
+  }
+  return this->rowPtr(row)[col];
+}
+
+S21_MATRIX_INLINE double* S21Matrix::operator[](int row) {
+  if (row >= _rows)
+    throw std::out_of_range("Incorrect input, index is out of range");
+
+  makeUnique();
+  return rowPtr(row);
+}
+
+S21_MATRIX_INLINE const double* S21Matrix::operator[](int row) const {
+  if (row >= _rows)
+    throw std::out_of_range("Incorrect input, index is out of range");
+
+  return rowPtr(row);
+}
+
+S21_MATRIX_INLINE int S21Matrix::getRow() const { return this->_rows; }
+
+S21_MATRIX_INLINE int S21Matrix::getCol() const { return this->_cols; }
+
+#endif
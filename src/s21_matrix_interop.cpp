@@ -0,0 +1,52 @@
+#include <climits>
+
+#include "s21_matrix_oop.h"
+
+S21Matrix S21Matrix::Wrap(double* data, int rows, int cols, int stride) {
+  if (rows <= 0 || cols <= 0) {
+    throw std::invalid_argument("Wrong size of matrix");
+  }
+  if (stride == 0) {
+    stride = cols;
+  }
+  if (data == nullptr || stride < cols) {
+    throw std::invalid_argument("Wrong layout of external memory");
+  }
+  S21Matrix res;
+  res._rows = rows;
+  res._cols = cols;
+  res._stride = stride;
+  res._matrix = data;
+  res._owner = false;
+  return res;
+}
+
+S21Matrix S21Matrix::FromDLTensor(const S21DLTensor& tensor) {
+  // only CPU float64 buffers with unit stride along a row can be viewed
+  if (tensor.device_type != 1 || tensor.ndim != 2 || tensor.dtype_code != 2 ||
+      tensor.dtype_bits != 64 || tensor.dtype_lanes != 1) {
+    throw std::invalid_argument("Unsupported tensor type");
+  }
+  if (tensor.strides[1] != 1 || tensor.shape[0] > INT_MAX ||
+      tensor.shape[1] > INT_MAX || tensor.strides[0] > INT_MAX ||
+      tensor.byte_offset % sizeof(double) != 0) {
+    throw std::invalid_argument("Wrong layout of external memory");
+  }
+  double* data = reinterpret_cast<double*>(static_cast<char*>(tensor.data) +
+                                           tensor.byte_offset);
+  int rows = static_cast<int>(tensor.shape[0]);
+  int cols = static_cast<int>(tensor.shape[1]);
+  int stride = static_cast<int>(tensor.strides[0]);
+  return Wrap(data, rows, cols, rows == 1 && stride == 0 ? cols : stride);
+}
+
+S21DLTensor S21Matrix::ToDLTensor() {
+  makeUnique();  // the consumer may write through the tensor
+  S21DLTensor tensor;
+  tensor.data = _matrix;
+  tensor.shape[0] = _rows;
+  tensor.shape[1] = _cols;
+  tensor.strides[0] = _stride;
+  tensor.strides[1] = 1;
+  return tensor;
+}
@@ -0,0 +1,271 @@
+#include "s21_matrix_lazy.h"
+
+#include <map>
+#include <tuple>
+#include <vector>
+
+struct S21Expr::Node {
+  enum Kind { kLeaf, kAdd, kSub, kMul, kScale, kTranspose };
+
+  Kind kind;
+  int rows, cols;
+  const S21Matrix* leaf;
+  std::shared_ptr<const Node> lhs, rhs;
+  double scalar;
+};
+
+namespace {
+
+const int kTile = 32;
+
+std::vector<const double*> rowPointers(const S21Matrix& m) {
+  std::vector<const double*> rows(m.getRow());
+  for (int i = 0; i < m.getRow(); ++i) rows[i] = m[i];
+  return rows;
+}
+
+}  // namespace
+
+// canonical form of an expression: structurally equal nodes share one step,
+// and every step knows how many parents consume it
+class S21ExprPlan {
+ private:
+  using Node = S21Expr::Node;
+
+  struct Step {
+    Node::Kind kind;
+    int lhs, rhs;
+    double scalar;
+    const S21Matrix* leaf;
+    int rows, cols;
+    int uses;
+  };
+
+  // the value scale * op(*m), where op transposes when trans is set
+  struct View {
+    const S21Matrix* m;
+    bool trans;
+    double scale;
+  };
+
+  std::vector<Step> _steps;
+  std::map<const Node*, int> _ids;
+  std::map<std::tuple<int, int, int, double, const S21Matrix*>, int> _canon;
+  std::vector<std::unique_ptr<S21Matrix>> _temps;
+  std::vector<bool> _evaluated;
+  std::vector<View> _views;
+  int _root;
+
+  int add(const Node* node);
+  View view(int id);
+  S21Matrix* materialize(int id);
+  bool peelProduct(int id, bool owned, int* mul, bool* trans, double* alpha);
+  void productInto(int mul, bool trans, double alpha, double beta,
+                   S21Matrix& out);
+  void accumulate(const View& v, double factor, bool assign, S21Matrix& out);
+
+ public:
+  explicit S21ExprPlan(const Node* root);
+  S21Matrix Run();
+};
+
+S21ExprPlan::S21ExprPlan(const Node* root) {
+  _root = add(root);
+  for (const Step& step : _steps) {
+    if (step.lhs >= 0) ++_steps[step.lhs].uses;
+    if (step.rhs >= 0) ++_steps[step.rhs].uses;
+  }
+  _evaluated.assign(_steps.size(), false);
+  _views.resize(_steps.size());
+}
+
+int S21ExprPlan::add(const Node* node) {
+  auto seen = _ids.find(node);
+  if (seen != _ids.end()) return seen->second;
+  int lhs = node->lhs ? add(node->lhs.get()) : -1;
+  int rhs = node->rhs ? add(node->rhs.get()) : -1;
+  auto key = std::make_tuple(static_cast<int>(node->kind), lhs, rhs,
+                             node->scalar, node->leaf);
+  auto canon = _canon.find(key);
+  int id;
+  if (canon != _canon.end()) {
+    id = canon->second;
+  } else {
+    id = static_cast<int>(_steps.size());
+    _steps.push_back({node->kind, lhs, rhs, node->scalar, node->leaf,
+                      node->rows, node->cols, 0});
+    _canon.emplace(key, id);
+  }
+  _ids.emplace(node, id);
+  return id;
+}
+
+S21ExprPlan::View S21ExprPlan::view(int id) {
+  if (_evaluated[id]) return _views[id];
+  const Step& step = _steps[id];
+  View v;
+  if (step.kind == Node::kLeaf) {
+    v = {step.leaf, false, 1};
+  } else if (step.kind == Node::kTranspose) {
+    v = view(step.lhs);
+    v.trans = !v.trans;
+  } else if (step.kind == Node::kScale) {
+    v = view(step.lhs);
+    v.scale *= step.scalar;
+  } else {
+    v = {materialize(id), false, 1};
+  }
+  _evaluated[id] = true;
+  _views[id] = v;
+  return v;
+}
+
+// follows a chain of scales and transposes down to a product that nothing
+// else uses, collecting the factor and orientation to fold into the GEMM
+bool S21ExprPlan::peelProduct(int id, bool owned, int* mul, bool* trans,
+                              double* alpha) {
+  *trans = false;
+  *alpha = 1;
+  for (int cur = id;; cur = _steps[cur].lhs) {
+    const Step& step = _steps[cur];
+    if ((cur != id || !owned) && (step.uses != 1 || _evaluated[cur])) {
+      return false;
+    }
+    if (step.kind == Node::kMul) {
+      *mul = cur;
+      return true;
+    } else if (step.kind == Node::kScale) {
+      *alpha *= step.scalar;
+    } else if (step.kind == Node::kTranspose) {
+      *trans = !*trans;
+    } else {
+      return false;
+    }
+  }
+}
+
+// out = alpha * op(product) + beta * out, with transposes and scales of the
+// product's operands passed to the kernel instead of being materialised
+void S21ExprPlan::productInto(int mul, bool trans, double alpha, double beta,
+                              S21Matrix& out) {
+  View x = view(_steps[mul].lhs), y = view(_steps[mul].rhs);
+  alpha *= x.scale * y.scale;
+  if (trans) {
+    std::swap(x, y);
+    x.trans = !x.trans;
+    y.trans = !y.trans;
+  }
+  out.Gemm(x.trans ? S21Op::kTrans : S21Op::kNoTrans,
+           y.trans ? S21Op::kTrans : S21Op::kNoTrans, alpha, *x.m, *y.m, beta);
+}
+
+// out = factor * v, or out += factor * v when assign is false
+void S21ExprPlan::accumulate(const View& v, double factor, bool assign,
+                             S21Matrix& out) {
+  const int rows = out.getRow(), cols = out.getCol();
+  const double f = factor * v.scale;
+  std::vector<const double*> src = rowPointers(*v.m);
+  if (!v.trans) {
+    for (int i = 0; i < rows; ++i) {
+      double* row = out[i];
+      for (int j = 0; j < cols; ++j) {
+        row[j] = (assign ? 0 : row[j]) + f * src[i][j];
+      }
+    }
+    return;
+  }
+  for (int ib = 0; ib < rows; ib += kTile) {
+    for (int jb = 0; jb < cols; jb += kTile) {
+      for (int i = ib; i < std::min(rows, ib + kTile); ++i) {
+        double* row = out[i];
+        for (int j = jb; j < std::min(cols, jb + kTile); ++j) {
+          row[j] = (assign ? 0 : row[j]) + f * src[j][i];
+        }
+      }
+    }
+  }
+}
+
+S21Matrix* S21ExprPlan::materialize(int id) {
+  const Step& step = _steps[id];
+  _temps.push_back(std::make_unique<S21Matrix>(step.rows, step.cols));
+  S21Matrix& out = *_temps.back();
+  int mul;
+  bool trans;
+  double alpha;
+  if (peelProduct(id, true, &mul, &trans, &alpha)) {
+    productInto(mul, trans, alpha, 0, out);
+  } else if (step.kind == Node::kAdd || step.kind == Node::kSub) {
+    const double sign = step.kind == Node::kSub ? -1 : 1;
+    if (peelProduct(step.rhs, false, &mul, &trans, &alpha)) {
+      accumulate(view(step.lhs), 1, true, out);
+      productInto(mul, trans, sign * alpha, 1, out);
+    } else if (peelProduct(step.lhs, false, &mul, &trans, &alpha)) {
+      accumulate(view(step.rhs), sign, true, out);
+      productInto(mul, trans, alpha, 1, out);
+    } else {
+      accumulate(view(step.lhs), 1, true, out);
+      accumulate(view(step.rhs), sign, false, out);
+    }
+  } else {
+    accumulate(view(id), 1, true, out);
+  }
+  return &out;
+}
+
+S21Matrix S21ExprPlan::Run() {
+  const Step& root = _steps[_root];
+  if (root.kind == Node::kLeaf) {
+    return S21Matrix(*root.leaf);
+  }
+  return std::move(*materialize(_root));
+}
+
+S21Expr::S21Expr(std::shared_ptr<const Node> node) : _node(std::move(node)) {}
+
+S21Expr::S21Expr(const S21Matrix& leaf)
+    : _node(std::make_shared<const Node>(Node{Node::kLeaf, leaf.getRow(),
+                                              leaf.getCol(), &leaf, nullptr,
+                                              nullptr, 1})) {}
+
+S21Expr S21Expr::operator+(const S21Expr& o) const {
+  if (getRow() != o.getRow() || getCol() != o.getCol()) {
+    throw std::invalid_argument("Different size of matrix");
+  }
+  return S21Expr(std::make_shared<const Node>(
+      Node{Node::kAdd, getRow(), getCol(), nullptr, _node, o._node, 1}));
+}
+
+S21Expr S21Expr::operator-(const S21Expr& o) const {
+  if (getRow() != o.getRow() || getCol() != o.getCol()) {
+    throw std::invalid_argument("Different size of matrix");
+  }
+  return S21Expr(std::make_shared<const Node>(
+      Node{Node::kSub, getRow(), getCol(), nullptr, _node, o._node, 1}));
+}
+
+S21Expr S21Expr::operator*(const S21Expr& o) const {
+  if (getCol() != o.getRow()) {
+    throw std::invalid_argument("Wrong size of matrixes");
+  }
+  return S21Expr(std::make_shared<const Node>(
+      Node{Node::kMul, getRow(), o.getCol(), nullptr, _node, o._node, 1}));
+}
+
+S21Expr S21Expr::operator*(double num) const {
+  return S21Expr(std::make_shared<const Node>(
+      Node{Node::kScale, getRow(), getCol(), nullptr, _node, nullptr, num}));
+}
+
+S21Expr operator*(double num, const S21Expr& o) { return o * num; }
+
+S21Expr S21Expr::Transpose() const {
+  return S21Expr(std::make_shared<const Node>(
+      Node{Node::kTranspose, getCol(), getRow(), nullptr, _node, nullptr, 1}));
+}
+
+int S21Expr::getRow() const { return _node->rows; }
+
+int S21Expr::getCol() const { return _node->cols; }
+
+S21Matrix S21Expr::Eval() const { return S21ExprPlan(_node.get()).Run(); }
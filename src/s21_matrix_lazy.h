@@ -0,0 +1,38 @@
+#ifndef __S21MATRIX_LAZY_H__
+#define __S21MATRIX_LAZY_H__
+
+#include <memory>
+
+#include "s21_matrix_oop.h"
+
+// deferred matrix expression. Building one only records the operation and
+// checks sizes; Eval() then shares identical sub-expressions, folds
+// transposes and scalar factors into the multiplications that consume them
+// and runs the resulting plan. Leaves refer to the original matrices, which
+// must stay alive and unchanged until Eval() returns.
+class S21Expr {
+ private:
+  struct Node;
+  std::shared_ptr<const Node> _node;
+
+  explicit S21Expr(std::shared_ptr<const Node> node);
+  friend class S21ExprPlan;
+
+ public:
+  S21Expr(const S21Matrix& leaf);
+
+  S21Expr operator+(const S21Expr& o) const;
+  S21Expr operator-(const S21Expr& o) const;
+  S21Expr operator*(const S21Expr& o) const;
+  S21Expr operator*(double num) const;
+  S21Expr Transpose() const;
+
+  int getRow() const;
+  int getCol() const;
+
+  S21Matrix Eval() const;
+};
+
+S21Expr operator*(double num, const S21Expr& o);
+
+#endif
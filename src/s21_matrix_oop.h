@@ -1,21 +1,142 @@
 #ifndef __S21MATRIX_H__
 #define __S21MATRIX_H__
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
+#include <stdexcept>
+#include <vector>
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+#endif
 #define EPS 10e-6
 
+// element-wise tolerance for S21Matrix::Compare: a pair of elements matches
+// when it passes any of the enabled bounds (rel and ulp are off when zero)
+struct S21Tolerance {
+  double abs = EPS;    // |a - b| <= abs
+  double rel = 0;      // |a - b| <= rel * max(|a|, |b|)
+  long long ulp = 0;   // a and b are at most ulp representable doubles apart
+};
+
+enum class S21CompareMode {
+  kFirst,  // stop at the first mismatching element
+  kMax     // scan everything and report the largest difference
+};
+
+// operand form for Gemm: used as stored or transposed
+enum class S21Op { kNoTrans, kTrans };
+
+// kernels behind Gemm, Solve, Determinant and InverseMatrix; kBlas is only
+// available in builds made with BACKEND=blas and is their default
+enum class S21Backend { kNative, kBlas };
+
+// where the pages of large matrix buffers (1 MiB and up) are placed on
+// NUMA machines; on a single node every policy behaves like kDefault
+enum class S21Placement {
+  kDefault,     // each page lands on the node of the thread writing it first
+  // block k of the rows is written first by worker k of
+  // S21Executor::Pinned(); run the kernels on that executor for locality
+  kFirstTouch,
+  kInterleave,  // pages alternate between all nodes
+  kBlocked      // consecutive row blocks go to consecutive nodes
+};
+
+// outcome of S21Matrix::SolveMixed
+struct S21RefineInfo {
+  int iterations = 0;     // refinement steps taken
+  bool fallback = false;  // refinement stalled, solved in double instead
+};
+
+// element-wise reductions for S21Matrix::Reduce
+enum class S21Reduction { kSum, kNorm, kMaxAbs, kMin, kMax };
+// kRows reduces each row to one value, kCols each column, kAll everything
+enum class S21Axis { kRows, kCols, kAll };
+
+// DLPack field set for a 2-D buffer (shape and strides stored inline,
+// strides counted in elements); bindings copy it into a DLTensor or a
+// Python buffer descriptor
+struct S21DLTensor {
+  void* data = nullptr;
+  int32_t device_type = 1;  // kDLCPU
+  int32_t device_id = 0;
+  int32_t ndim = 2;
+  uint8_t dtype_code = 2;  // kDLFloat
+  uint8_t dtype_bits = 64;
+  uint16_t dtype_lanes = 1;
+  int64_t shape[2] = {0, 0};
+  int64_t strides[2] = {0, 1};
+  uint64_t byte_offset = 0;
+};
+
+class S21Executor;
+class S21MatrixCache;
+class S21Vector;
+struct S21EigenResult;
+struct S21SvdResult;
+
+struct S21CompareResult {
+  bool equal = true;  // same size and every element within tolerance
+  int row = -1;       // position of the reported element, -1 if none
+  int col = -1;
+  double diff = 0;  // |a - b| at (row, col)
+};
+
+// Thread safety: const member functions may run concurrently on the same
+// matrix. A matrix that is being modified must not be used from any other
+// thread; non-const accessors such as operator() count as modifications
+// even when they only read. Distinct matrices, including copies sharing a
+// copy-on-write buffer, are independent. The static settings are atomic.
 class S21Matrix {
+  friend class S21MatrixCache;
+
  private:
   // attributes
   int _rows, _cols;  // rows and columns attributes
-  double** _matrix;  // pointer to the memory where the matrix will be allocated
+  int _stride;       // elements between the starts of consecutive rows
+  double* _matrix;   // row-major storage, row i starts at _matrix + i * _stride
+  bool _owner;       // false for matrices wrapping external memory
+  // owners of a copy-on-write buffer; null for buffers that are never shared
+  std::atomic<int>* _refs;
+  uint64_t _id;       // unique for the lifetime of the program
+  uint64_t _version;  // changes on every modification
+  // an S21MatrixCache holds results for _id; they are dropped on destruction
+  mutable std::atomic<bool> _cached;
 
   // privte methods
   void createMatrix();
   void deleteMatrix();
-  S21Matrix createMinor(int row, int col);
+  void copyElements(const S21Matrix& o);  // same size, any strides
+  void detach();  // takes a private copy of a shared buffer
+  // called before every write: marks the contents as changed and clones a
+  // shared copy-on-write buffer
+  void makeUnique() {
+    ++_version;
+    if (_refs) detach();
+  }
+  S21Matrix createMinor(int row, int col) const;
+  size_t size() const { return static_cast<size_t>(_rows) * _cols; }
+  static void forgetCached(uint64_t id);  // s21_matrix_cache.cpp
+  double blasDeterminant() const;
+  S21Matrix blasInverse() const;
+  double* rowPtr(int row) const {
+    return _matrix + static_cast<size_t>(row) * _stride;
+  }
+  // the elements as one dense row-major array converted to T
+  template <class T>
+  std::vector<T> packed() const {
+    std::vector<T> res(size());
+    for (int i = 0; i < _rows; ++i) {
+      std::copy(rowPtr(i), rowPtr(i) + _cols,
+                res.begin() + static_cast<size_t>(i) * _cols);
+    }
+    return res;
+  }
 
  public:
   S21Matrix();                    // default constructor
@@ -25,37 +146,188 @@ class S21Matrix {
   ~S21Matrix();                   // destructor
 
   // some operators overloads
-  S21Matrix& operator=(const S21Matrix& o);  // assignment operator overload
+  // assignment operator overload; keeps the buffer when the sizes match
+  S21Matrix& operator=(const S21Matrix& o);
+  S21Matrix& operator=(S21Matrix&& o);       // move assignment
   double& operator()(int row, int col);      // index operator overload
-  int& operator()(int row, int col) const;
+  const double& operator()(int row, int col) const;
   S21Matrix& operator+=(const S21Matrix& o);
-  S21Matrix operator+(const S21Matrix& o);
+  S21Matrix operator+(const S21Matrix& o) const;
   S21Matrix& operator-=(const S21Matrix& o);
-  S21Matrix operator-(const S21Matrix& o);
+  S21Matrix operator-(const S21Matrix& o) const;
   S21Matrix& operator*=(const S21Matrix& o);
-  S21Matrix operator*(const S21Matrix& o);
+  S21Matrix operator*(const S21Matrix& o) const;
   S21Matrix& operator*=(const double& num);
-  S21Matrix operator*(const double& num);
-  bool operator==(const S21Matrix& o);
-  double* operator[](int row) const;
+  S21Matrix operator*(const double& num) const;
+  bool operator==(const S21Matrix& o) const;
+  double* operator[](int row);
+  const double* operator[](int row) const;
 
   // some public methods
-  bool EqMatrix(const S21Matrix& o);
+  bool EqMatrix(const S21Matrix& o) const;
+  bool EqMatrix(const S21Matrix& o, const S21Tolerance& tol) const;
+  S21CompareResult Compare(
+      const S21Matrix& o, const S21Tolerance& tol = S21Tolerance(),
+      S21CompareMode mode = S21CompareMode::kFirst) const;
   void SumMatrix(const S21Matrix& o);
   void SubMatrix(const S21Matrix& o);
   void MulMatrix(const S21Matrix& o);
+  // *this = alpha * op(a) * op(b) + beta * *this, BLAS dgemm semantics;
+  // with beta == 0 the old contents are ignored and *this is resized
+  void Gemm(S21Op op_a, S21Op op_b, double alpha, const S21Matrix& a,
+            const S21Matrix& b, double beta = 0);
+  // *this += alpha * x * y^T, BLAS dger semantics (s21_vector.cpp)
+  void Ger(double alpha, const S21Vector& x, const S21Vector& y,
+           S21Executor* executor = nullptr);
   void MulNumber(const double num);
-  S21Matrix Transpose();
-  S21Matrix CalcComplements();
-  double Determinant();
-  S21Matrix InverseMatrix();
+  S21Matrix Transpose() const;
+  S21Matrix CalcComplements() const;
+  double Determinant() const;
+  S21Matrix InverseMatrix() const;
+  S21Matrix Solve(const S21Matrix& b) const;  // x such that *this * x = b
+  // Solve with a float factorisation refined to double accuracy; falls back
+  // to Solve when refinement does not converge. It only beats Solve when the
+  // float kernels are vectorised, i.e. in BUILD=release (-O3); the default
+  // debug build has no optimisation and runs it slower than Solve
+  S21Matrix SolveMixed(const S21Matrix& b,
+                       S21RefineInfo* info = nullptr) const;
+
+  static void setBackend(S21Backend backend);
+  static S21Backend getBackend();
+  // copy-on-write: matrices created while it is on share their buffer with
+  // their copies, the reference count is atomic, and the first write through
+  // any non-const accessor or operation clones it. Off by default.
+  static void setCopyOnWrite(bool enabled);
+  static bool getCopyOnWrite();
+  bool isShared() const;  // the buffer is currently shared with a copy
+  // applies to buffers allocated afterwards (s21_numa.cpp)
+  static void setPlacement(S21Placement placement);
+  static S21Placement getPlacement();
+
+  // decompositions (s21_matrix_decomp.cpp); the eigensolvers read only the
+  // lower triangle, results are sorted in descending order. Singular vectors
+  // of zero singular values are completed to an orthonormal basis.
+  S21EigenResult EigenSymmetric(bool vectors = true) const;
+  S21EigenResult EigenSymmetricTopK(int k) const;
+  S21SvdResult Svd() const;
+  // goes through the Gram matrix, which squares the condition number: a
+  // singular value s loses about half its digits relative to s(0), and those
+  // below sqrt(eps) * s(0) are noise; use Svd() when they matter
+  S21SvdResult SvdTopK(int k) const;
+
+  // raw access without range checks: rows are contiguous and row i starts
+  // at data() + i * stride()
+  double* data() {
+    makeUnique();
+    return _matrix;
+  }
+  const double* data() const { return _matrix; }
+  int stride() const { return _stride; }
+  // records writes made through a pointer or span obtained earlier, or to
+  // the memory behind a Wrap view, so cached results are not reused
+  void MarkModified() { ++_version; }
+  bool ownsData() const { return _owner; }
+
+  // zero-copy interop (s21_matrix_interop.cpp). A wrapped matrix reads and
+  // writes the external memory, which must outlive it; copies of it are
+  // ordinary owning matrices, and resizing detaches it.
+  static S21Matrix Wrap(double* data, int rows, int cols, int stride = 0);
+  static S21Matrix FromDLTensor(const S21DLTensor& tensor);
+  S21DLTensor ToDLTensor();
+  double& at_unchecked(int row, int col) {
+    makeUnique();
+    return rowPtr(row)[col];
+  }
+  const double& at_unchecked(int row, int col) const {
+    return rowPtr(row)[col];
+  }
+  // checked by assert only, so release builds (NDEBUG) pay nothing
+  double& at(int row, int col) {
+    assert(row >= 0 && row < _rows && col >= 0 && col < _cols);
+    makeUnique();
+    return rowPtr(row)[col];
+  }
+  const double& at(int row, int col) const {
+    assert(row >= 0 && row < _rows && col >= 0 && col < _cols);
+    return rowPtr(row)[col];
+  }
+#ifdef __cpp_lib_span
+  std::span<double> row(int i) {
+    assert(i >= 0 && i < _rows);
+    makeUnique();
+    return {rowPtr(i), static_cast<size_t>(_cols)};
+  }
+  std::span<const double> row(int i) const {
+    assert(i >= 0 && i < _rows);
+    return {rowPtr(i), static_cast<size_t>(_cols)};
+  }
+#endif
+
+  // reductions (s21_matrix_reduce.cpp): kRows returns a rows x 1 column,
+  // kCols a 1 x cols row and kAll a 1 x 1 matrix; with an executor the rows
+  // are split between its threads. A NaN in the input makes every reduction
+  // over it NaN.
+  S21Matrix Reduce(S21Reduction op, S21Axis axis,
+                   S21Executor* executor = nullptr) const;
+  double Sum() const;
+  double NormFrobenius() const;
+  double MaxAbs() const;
+  void HadamardMatrix(const S21Matrix& o);  // element-wise product
+  // element-wise maps in one pass: x = f(x), or x = f(x, y) with y from o
+  template <class F>
+  S21Matrix& Apply(F f);
+  template <class F>
+  S21Matrix& Apply(const S21Matrix& o, F f);
 
-  int getRow();
-  int getCol();
+  int getRow() const;
+  int getCol() const;
   void setRow(int row);
   void setCol(int col);
 
   //   void printMatrix();
 };
 
-#endif
\ No newline at end of file
+template <class F>
+S21Matrix& S21Matrix::Apply(F f) {
+  makeUnique();
+  for (int i = 0; i < _rows; ++i) {
+    double* x = rowPtr(i);
+    for (int j = 0; j < _cols; ++j) x[j] = f(x[j]);
+  }
+  return *this;
+}
+
+template <class F>
+S21Matrix& S21Matrix::Apply(const S21Matrix& o, F f) {
+  if (_rows != o._rows || _cols != o._cols) {
+    throw std::invalid_argument("Different size of matrix");
+  }
+  makeUnique();
+  for (int i = 0; i < _rows; ++i) {
+    double* x = rowPtr(i);
+    const double* y = o.rowPtr(i);
+    for (int j = 0; j < _cols; ++j) x[j] = f(x[j], y[j]);
+  }
+  return *this;
+}
+
+// A = vectors * diag(values) * vectors^T; values is a column, vectors holds
+// one eigenvector per column (empty when they were not requested)
+struct S21EigenResult {
+  S21Matrix values;
+  S21Matrix vectors;
+};
+
+// thin SVD A = u * diag(s) * v^T with s a column of singular values
+struct S21SvdResult {
+  S21Matrix u;
+  S21Matrix s;
+  S21Matrix v;
+};
+
+#ifdef S21_INLINE_ACCESSORS
+#define S21_MATRIX_INLINE inline
+#include "s21_matrix_inline.h"
+#endif
+
+#endif
@@ -0,0 +1,166 @@
+#include <mutex>
+#include <vector>
+
+#include "s21_executor.h"
+#include "s21_matrix_oop.h"
+
+namespace {
+
+// independent accumulators per row, so the loop is not one serial chain
+const int kLanes = 4;
+// rows handed to a thread at a time cover at least this many elements
+const int kParallelGrain = 1 << 16;
+
+struct SumOp {
+  static double identity() { return 0; }
+  static double step(double acc, double x) { return acc + x; }
+  static double merge(double a, double b) { return a + b; }
+  static double finish(double acc) { return acc; }
+};
+
+struct NormOp {
+  static double identity() { return 0; }
+  static double step(double acc, double x) { return acc + x * x; }
+  static double merge(double a, double b) { return a + b; }
+  static double finish(double acc) { return std::sqrt(acc); }
+};
+
+// the extrema propagate NaN like Sum and Norm do, where std::fmax and
+// std::fmin would drop it: once an operand is NaN the result stays NaN
+inline double nanMax(double a, double b) {
+  return (b > a || std::isnan(b)) ? b : a;
+}
+inline double nanMin(double a, double b) {
+  return (b < a || std::isnan(b)) ? b : a;
+}
+
+struct MaxAbsOp {
+  static double identity() { return 0; }
+  static double step(double acc, double x) {
+    return nanMax(acc, std::fabs(x));
+  }
+  static double merge(double a, double b) { return nanMax(a, b); }
+  static double finish(double acc) { return acc; }
+};
+
+struct MinOp {
+  static double identity() { return INFINITY; }
+  static double step(double acc, double x) { return nanMin(acc, x); }
+  static double merge(double a, double b) { return nanMin(a, b); }
+  static double finish(double acc) { return acc; }
+};
+
+struct MaxOp {
+  static double identity() { return -INFINITY; }
+  static double step(double acc, double x) { return nanMax(acc, x); }
+  static double merge(double a, double b) { return nanMax(a, b); }
+  static double finish(double acc) { return acc; }
+};
+
+template <class Op>
+double reduceRow(const double* x, int n) {
+  double acc[kLanes];
+  for (double& a : acc) a = Op::identity();
+  int j = 0;
+  for (; j + kLanes <= n; j += kLanes) {
+    for (int l = 0; l < kLanes; ++l) acc[l] = Op::step(acc[l], x[j + l]);
+  }
+  double res = Op::identity();
+  for (double a : acc) res = Op::merge(res, a);
+  for (; j < n; ++j) res = Op::step(res, x[j]);
+  return res;
+}
+
+template <class Op>
+S21Matrix reduce(const S21Matrix& m, S21Axis axis, S21Executor* executor) {
+  const int rows = m.getRow(), cols = m.getCol();
+  auto row = [&m](int i) {
+    return m.data() + static_cast<size_t>(i) * m.stride();
+  };
+  auto run = [&](const std::function<void(int, int)>& body) {
+    if (executor) {
+      executor->ParallelFor(0, rows, std::max(1, kParallelGrain / cols), body);
+    } else {
+      body(0, rows);
+    }
+  };
+  std::mutex mutex;
+  if (axis == S21Axis::kRows) {
+    S21Matrix res(rows, 1);
+    // the workers write through a raw pointer: the non-const accessors bump
+    // the version of res, which must not happen from several threads
+    double* out = res.data();
+    const size_t stride = res.stride();
+    run([&](int from, int to) {
+      for (int i = from; i < to; ++i) {
+        out[i * stride] = Op::finish(reduceRow<Op>(row(i), cols));
+      }
+    });
+    return res;
+  } else if (axis == S21Axis::kCols) {
+    std::vector<double> total(cols, Op::identity());
+    run([&](int from, int to) {
+      std::vector<double> acc(cols, Op::identity());
+      for (int i = from; i < to; ++i) {
+        const double* x = row(i);
+        for (int j = 0; j < cols; ++j) acc[j] = Op::step(acc[j], x[j]);
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      for (int j = 0; j < cols; ++j) total[j] = Op::merge(total[j], acc[j]);
+    });
+    S21Matrix res(1, cols);
+    for (int j = 0; j < cols; ++j) {
+      res.at_unchecked(0, j) = Op::finish(total[j]);
+    }
+    return res;
+  }
+  double total = Op::identity();
+  run([&](int from, int to) {
+    double acc = Op::identity();
+    for (int i = from; i < to; ++i) {
+      acc = Op::merge(acc, reduceRow<Op>(row(i), cols));
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    total = Op::merge(total, acc);
+  });
+  S21Matrix res(1, 1);
+  res.at_unchecked(0, 0) = Op::finish(total);
+  return res;
+}
+
+}  // namespace
+
+S21Matrix S21Matrix::Reduce(S21Reduction op, S21Axis axis,
+                            S21Executor* executor) const {
+  if (_rows == 0) {
+    throw std::invalid_argument("Wrong size of matrix");
+  }
+  switch (op) {
+    case S21Reduction::kSum:
+      return reduce<SumOp>(*this, axis, executor);
+    case S21Reduction::kNorm:
+      return reduce<NormOp>(*this, axis, executor);
+    case S21Reduction::kMaxAbs:
+      return reduce<MaxAbsOp>(*this, axis, executor);
+    case S21Reduction::kMin:
+      return reduce<MinOp>(*this, axis, executor);
+    default:
+      return reduce<MaxOp>(*this, axis, executor);
+  }
+}
+
+double S21Matrix::Sum() const {
+  return Reduce(S21Reduction::kSum, S21Axis::kAll).at_unchecked(0, 0);
+}
+
+double S21Matrix::NormFrobenius() const {
+  return Reduce(S21Reduction::kNorm, S21Axis::kAll).at_unchecked(0, 0);
+}
+
+double S21Matrix::MaxAbs() const {
+  return Reduce(S21Reduction::kMaxAbs, S21Axis::kAll).at_unchecked(0, 0);
+}
+
+void S21Matrix::HadamardMatrix(const S21Matrix& o) {
+  Apply(o, [](double x, double y) { return x * y; });
+}
@@ -0,0 +1,210 @@
+#include <cfloat>
+#include <vector>
+
+#include "s21_blas.h"
+#include "s21_matrix_oop.h"
+
+namespace {
+
+const int kMaxRefinements = 30;
+
+// y[0, n) -= a * x[0, n) over two distinct rows. Saying that they do not
+// overlap lets the compiler vectorise at the full width of T (4 floats per
+// SSE register against 2 doubles) without versioning the loop for aliasing;
+// it only does so with optimisation on, as in BUILD=release
+template <class T>
+inline void axpyRow(T* __restrict y, T a, const T* __restrict x, int n) {
+  for (int j = 0; j < n; ++j) y[j] -= a * x[j];
+}
+
+// in-place LU with partial pivoting of a row-major n x n matrix; row k was
+// swapped with row piv[k]. Returns false when a pivot is exactly zero.
+template <class T>
+bool luFactor(T* a, int n, int* piv) {
+  for (int k = 0; k < n; ++k) {
+    int p = k;
+    for (int i = k + 1; i < n; ++i) {
+      if (std::fabs(a[i * n + k]) > std::fabs(a[p * n + k])) p = i;
+    }
+    piv[k] = p;
+    if (a[p * n + k] == 0) {
+      return false;
+    }
+    if (p != k) {
+      std::swap_ranges(a + k * n, a + (k + 1) * n, a + p * n);
+    }
+    const T* pivot_row = a + k * n;
+    for (int i = k + 1; i < n; ++i) {
+      T* row = a + i * n;
+      T l = row[k] /= pivot_row[k];
+      axpyRow(row + k + 1, l, pivot_row + k + 1, n - k - 1);
+    }
+  }
+  return true;
+}
+
+// solves LU x = P b in place for the row-major n x nrhs right-hand side b
+template <class T>
+void luSolve(const T* lu, int n, const int* piv, T* b, int nrhs) {
+  for (int k = 0; k < n; ++k) {
+    if (piv[k] != k) {
+      std::swap_ranges(b + k * nrhs, b + (k + 1) * nrhs, b + piv[k] * nrhs);
+    }
+  }
+  for (int i = 0; i < n; ++i) {
+    T* bi = b + i * nrhs;
+    for (int p = 0; p < i; ++p) axpyRow(bi, lu[i * n + p], b + p * nrhs, nrhs);
+  }
+  for (int i = n - 1; i >= 0; --i) {
+    T* bi = b + i * nrhs;
+    for (int p = i + 1; p < n; ++p) {
+      axpyRow(bi, lu[i * n + p], b + p * nrhs, nrhs);
+    }
+    for (int j = 0; j < nrhs; ++j) bi[j] /= lu[i * n + i];
+  }
+}
+
+}  // namespace
+
+S21Matrix S21Matrix::Solve(const S21Matrix& b) const {
+  if (_rows != _cols) {
+    throw std::invalid_argument("Matrix is not sqared");
+  }
+  if (b._rows != _rows) {
+    throw std::invalid_argument("Wrong size of matrixes");
+  }
+  const int n = _rows;
+  S21Matrix x(b);
+  x.makeUnique();  // solved in place below
+#ifdef S21_USE_BLAS
+  if (getBackend() == S21Backend::kBlas) {
+    // LAPACK is column-major: pass transposed copies of A and B
+    std::vector<double> a(size()), rhs(x.size());
+    std::vector<int> ipiv(n);
+    for (int i = 0; i < n; ++i) {
+      for (int j = 0; j < n; ++j) a[i + j * n] = rowPtr(i)[j];
+      for (int j = 0; j < x._cols; ++j) rhs[i + j * n] = x.rowPtr(i)[j];
+    }
+    int nrhs = x._cols, info = 0;
+    dgesv_(&n, &nrhs, a.data(), &n, ipiv.data(), rhs.data(), &n, &info);
+    if (info > 0) {
+      throw std::logic_error("Determinant = 0");
+    }
+    for (int i = 0; i < n; ++i) {
+      for (int j = 0; j < x._cols; ++j) x.rowPtr(i)[j] = rhs[i + j * n];
+    }
+    return x;
+  }
+#endif
+  std::vector<double> lu = packed<double>();
+  std::vector<int> piv(n);
+  if (!luFactor(lu.data(), n, piv.data())) {
+    throw std::logic_error("Determinant = 0");
+  }
+  luSolve(lu.data(), n, piv.data(), x._matrix, x._cols);
+  return x;
+}
+
+S21Matrix S21Matrix::SolveMixed(const S21Matrix& b,
+                                S21RefineInfo* info) const {
+  if (_rows != _cols) {
+    throw std::invalid_argument("Matrix is not sqared");
+  }
+  if (b._rows != _rows) {
+    throw std::invalid_argument("Wrong size of matrixes");
+  }
+  S21RefineInfo stats;
+  const int n = _rows, nrhs = b._cols;
+  std::vector<float> lu = packed<float>();
+  std::vector<int> piv(n);
+  bool usable = true;
+  for (float v : lu) usable &= std::isfinite(v);
+  usable = usable && luFactor(lu.data(), n, piv.data());
+
+  S21Matrix x(n, nrhs);
+  if (usable) {
+    std::vector<float> dx = b.packed<float>();
+    luSolve(lu.data(), n, piv.data(), dx.data(), nrhs);
+    std::copy(dx.begin(), dx.end(), x._matrix);
+
+    double norm_a = 0;
+    for (int i = 0; i < n; ++i) {
+      double s = 0;
+      for (int j = 0; j < n; ++j) s += std::fabs(rowPtr(i)[j]);
+      norm_a = std::max(norm_a, s);
+    }
+    // stop once the residual is at the level of double rounding, give up
+    // when a step does not at least halve it
+    const double scale =
+        std::sqrt(static_cast<double>(n)) * DBL_EPSILON * norm_a;
+    double prev = INFINITY;
+    usable = false;
+    for (; stats.iterations <= kMaxRefinements; ++stats.iterations) {
+      S21Matrix r(b);
+      r.Gemm(S21Op::kNoTrans, S21Op::kNoTrans, -1, *this, x, 1);
+      double norm_r = 0, norm_x = 0;
+      for (size_t k = 0; k < r.size(); ++k) {
+        norm_r = std::max(norm_r, std::fabs(r._matrix[k]));
+        norm_x = std::max(norm_x, std::fabs(x._matrix[k]));
+      }
+      if (norm_r <= scale * norm_x) {
+        usable = true;
+        break;
+      }
+      if (!(norm_r < prev / 2)) {
+        break;
+      }
+      prev = norm_r;
+      std::copy(r._matrix, r._matrix + r.size(), dx.begin());
+      luSolve(lu.data(), n, piv.data(), dx.data(), nrhs);
+      for (size_t k = 0; k < x.size(); ++k) x._matrix[k] += dx[k];
+    }
+  }
+  if (!usable) {
+    stats.fallback = true;
+    x = Solve(b);
+  }
+  if (info) {
+    *info = stats;
+  }
+  return x;
+}
+
+#ifdef S21_USE_BLAS
+// the row-major storage read as column-major is A^T, which has the same
+// determinant and whose inverse read back row-major is A^-1
+double S21Matrix::blasDeterminant() const {
+  const int n = _rows;
+  std::vector<double> a = packed<double>();
+  std::vector<int> ipiv(n);
+  int info = 0;
+  dgetrf_(&n, &n, a.data(), &n, ipiv.data(), &info);
+  if (info > 0) {
+    return 0;
+  }
+  double det = 1;
+  for (int i = 0; i < n; ++i) {
+    det *= ipiv[i] != i + 1 ? -a[i * n + i] : a[i * n + i];
+  }
+  return det;
+}
+
+S21Matrix S21Matrix::blasInverse() const {
+  const int n = _rows;
+  S21Matrix res(*this);
+  res.makeUnique();  // factorised in place below
+  std::vector<int> ipiv(n);
+  int info = 0;
+  dgetrf_(&n, &n, res._matrix, &n, ipiv.data(), &info);
+  if (info > 0) {
+    throw std::logic_error("Determinant = 0");
+  }
+  double query = 0;
+  int lwork = -1;
+  dgetri_(&n, res._matrix, &n, ipiv.data(), &query, &lwork, &info);
+  lwork = std::max(1, static_cast<int>(query));
+  std::vector<double> work(lwork);
+  dgetri_(&n, res._matrix, &n, ipiv.data(), work.data(), &lwork, &info);
+  return res;
+}
+#endif
@@ -0,0 +1,583 @@
+#include "s21_matrix_structured.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+void checkSize(int n) {
+  if (n <= 0) {
+    throw std::invalid_argument("Wrong size of matrix");
+  }
+}
+
+void checkSquare(const S21Matrix& m) {
+  if (m.getRow() != m.getCol()) {
+    throw std::invalid_argument("Matrix is not sqared");
+  }
+}
+
+void checkIndex(int n, int row, int col) {
+  if (row < 0 || col < 0 || row >= n || col >= n) {
+    throw std::out_of_range("Incorrect input, index is out of range");
+  }
+}
+
+void checkOperand(int n, const S21Matrix& x) {
+  if (x.getRow() != n) {
+    throw std::invalid_argument("Wrong size of matrixes");
+  }
+}
+
+[[noreturn]] void outsideStructure() {
+  throw std::out_of_range("Element is outside the stored structure");
+}
+
+// y[0, k) += a * x[0, k): one row of a multi-column right-hand side
+inline void axpyRow(double* y, double a, const double* x, int k) {
+  for (int c = 0; c < k; ++c) y[c] += a * x[c];
+}
+
+}  // namespace
+
+// band
+
+S21BandMatrix::S21BandMatrix(int n, int lower, int upper)
+    : _n(n), _lower(lower), _upper(upper) {
+  checkSize(n);
+  if (lower < 0 || upper < 0) {
+    throw std::invalid_argument("Wrong size of matrix");
+  }
+  _lower = std::min(lower, n - 1);
+  _upper = std::min(upper, n - 1);
+  _data.assign(static_cast<size_t>(n) * width(), 0);
+}
+
+S21BandMatrix::S21BandMatrix(const S21Matrix& m, int lower, int upper)
+    : S21BandMatrix(m.getRow(), lower, upper) {
+  checkSquare(m);
+  for (int i = 0; i < _n; ++i) {
+    for (int j = std::max(0, i - _lower); j <= std::min(_n - 1, i + _upper);
+         ++j) {
+      (*this)(i, j) = m(i, j);
+    }
+  }
+}
+
+double& S21BandMatrix::operator()(int row, int col) {
+  checkIndex(_n, row, col);
+  if (!inBand(row, col)) {
+    outsideStructure();
+  }
+  return _data[static_cast<size_t>(row) * width() + col - row + _lower];
+}
+
+double S21BandMatrix::operator()(int row, int col) const {
+  checkIndex(_n, row, col);
+  if (!inBand(row, col)) {
+    return 0;
+  }
+  return _data[static_cast<size_t>(row) * width() + col - row + _lower];
+}
+
+S21Matrix S21BandMatrix::ToMatrix() const {
+  S21Matrix res(_n, _n);
+  for (int i = 0; i < _n; ++i) {
+    for (int j = std::max(0, i - _lower); j <= std::min(_n - 1, i + _upper);
+         ++j) {
+      res.at_unchecked(i, j) = (*this)(i, j);
+    }
+  }
+  return res;
+}
+
+S21Matrix S21BandMatrix::Mul(const S21Matrix& x) const {
+  checkOperand(_n, x);
+  const int k = x.getCol();
+  S21Matrix res(_n, k);
+  double* y = res.data();
+  for (int i = 0; i < _n; ++i) {
+    const double* band = _data.data() + static_cast<size_t>(i) * width();
+    const int from = std::max(0, i - _lower);
+    const int to = std::min(_n - 1, i + _upper);
+    for (int j = from; j <= to; ++j) {
+      axpyRow(y + static_cast<size_t>(i) * res.stride(),
+              band[j - i + _lower],
+              x.data() + static_cast<size_t>(j) * x.stride(), k);
+    }
+  }
+  return res;
+}
+
+bool S21BandMatrix::factor(std::vector<double>& lu, std::vector<int>& piv,
+                           int& swaps) const {
+  // row i keeps columns i - lower .. i + lower + upper: pivoting can move a
+  // row up by at most lower, widening the upper band by as much
+  const int reach = _lower + _upper;
+  const size_t w = static_cast<size_t>(_lower) + reach + 1;
+  lu.assign(static_cast<size_t>(_n) * w, 0);
+  auto at = [&lu, w, this](int i, int j) -> double& {
+    return lu[static_cast<size_t>(i) * w + j - i + _lower];
+  };
+  for (int i = 0; i < _n; ++i) {
+    const double* band = _data.data() + static_cast<size_t>(i) * width();
+    for (int j = std::max(0, i - _lower); j <= std::min(_n - 1, i + _upper);
+         ++j) {
+      at(i, j) = band[j - i + _lower];
+    }
+  }
+  piv.assign(_n, 0);
+  swaps = 0;
+  for (int k = 0; k < _n; ++k) {
+    const int last_row = std::min(_n - 1, k + _lower);
+    const int last_col = std::min(_n - 1, k + reach);
+    int p = k;
+    for (int i = k + 1; i <= last_row; ++i) {
+      if (std::fabs(at(i, k)) > std::fabs(at(p, k))) p = i;
+    }
+    piv[k] = p;
+    if (at(p, k) == 0) {
+      return false;
+    }
+    if (p != k) {
+      ++swaps;
+      for (int j = k; j <= last_col; ++j) std::swap(at(k, j), at(p, j));
+    }
+    // multipliers stay in column k; later swaps only touch columns > k
+    for (int i = k + 1; i <= last_row; ++i) {
+      const double l = at(i, k) /= at(k, k);
+      for (int j = k + 1; j <= last_col; ++j) at(i, j) -= l * at(k, j);
+    }
+  }
+  return true;
+}
+
+S21Matrix S21BandMatrix::Solve(const S21Matrix& b) const {
+  checkOperand(_n, b);
+  std::vector<double> lu;
+  std::vector<int> piv;
+  int swaps;
+  if (!factor(lu, piv, swaps)) {
+    throw std::logic_error("Determinant = 0");
+  }
+  const int reach = _lower + _upper;
+  const size_t w = static_cast<size_t>(_lower) + reach + 1;
+  auto at = [&lu, w, this](int i, int j) {
+    return lu[static_cast<size_t>(i) * w + j - i + _lower];
+  };
+  const int k = b.getCol();
+  S21Matrix x(b);
+  double* xd = x.data();
+  auto row = [xd, &x](int i) {
+    return xd + static_cast<size_t>(i) * x.stride();
+  };
+  for (int p = 0; p < _n; ++p) {
+    if (piv[p] != p) {
+      std::swap_ranges(row(p), row(p) + k, row(piv[p]));
+    }
+    for (int i = p + 1; i <= std::min(_n - 1, p + _lower); ++i) {
+      axpyRow(row(i), -at(i, p), row(p), k);
+    }
+  }
+  for (int i = _n - 1; i >= 0; --i) {
+    for (int j = i + 1; j <= std::min(_n - 1, i + reach); ++j) {
+      axpyRow(row(i), -at(i, j), row(j), k);
+    }
+    const double d = at(i, i);
+    for (int c = 0; c < k; ++c) row(i)[c] /= d;
+  }
+  return x;
+}
+
+double S21BandMatrix::Determinant() const {
+  std::vector<double> lu;
+  std::vector<int> piv;
+  int swaps;
+  if (!factor(lu, piv, swaps)) {
+    return 0;
+  }
+  const size_t w = static_cast<size_t>(2 * _lower + _upper + 1);
+  double res = swaps % 2 ? -1 : 1;
+  for (int i = 0; i < _n; ++i) res *= lu[i * w + _lower];
+  return res;
+}
+
+int S21BandMatrix::getSize() const { return _n; }
+
+int S21BandMatrix::getLower() const { return _lower; }
+
+int S21BandMatrix::getUpper() const { return _upper; }
+
+// triangular
+
+S21TriangularMatrix::S21TriangularMatrix(int n, S21Triangle uplo)
+    : _n(n), _uplo(uplo) {
+  checkSize(n);
+  _data.assign(static_cast<size_t>(n) * (n + 1) / 2, 0);
+}
+
+S21TriangularMatrix::S21TriangularMatrix(const S21Matrix& m, S21Triangle uplo)
+    : S21TriangularMatrix(m.getRow(), uplo) {
+  checkSquare(m);
+  for (int i = 0; i < _n; ++i) {
+    for (int j = 0; j < _n; ++j) {
+      if (stored(i, j)) _data[index(i, j)] = m(i, j);
+    }
+  }
+}
+
+size_t S21TriangularMatrix::index(int row, int col) const {
+  const size_t i = row;
+  if (_uplo == S21Triangle::kLower) {
+    return i * (i + 1) / 2 + col;
+  }
+  // rows above i hold n, n - 1, ..., n - i + 1 elements
+  return i * _n - i * (i - 1) / 2 + (col - row);
+}
+
+double& S21TriangularMatrix::operator()(int row, int col) {
+  checkIndex(_n, row, col);
+  if (!stored(row, col)) {
+    outsideStructure();
+  }
+  return _data[index(row, col)];
+}
+
+double S21TriangularMatrix::operator()(int row, int col) const {
+  checkIndex(_n, row, col);
+  return stored(row, col) ? _data[index(row, col)] : 0;
+}
+
+S21Matrix S21TriangularMatrix::ToMatrix() const {
+  S21Matrix res(_n, _n);
+  for (int i = 0; i < _n; ++i) {
+    for (int j = 0; j < _n; ++j) {
+      if (stored(i, j)) res.at_unchecked(i, j) = _data[index(i, j)];
+    }
+  }
+  return res;
+}
+
+S21Matrix S21TriangularMatrix::Mul(const S21Matrix& x) const {
+  checkOperand(_n, x);
+  const int k = x.getCol();
+  S21Matrix res(_n, k);
+  double* y = res.data();
+  const bool lower = _uplo == S21Triangle::kLower;
+  for (int i = 0; i < _n; ++i) {
+    const int from = lower ? 0 : i, to = lower ? i : _n - 1;
+    const double* a = _data.data() + index(i, from);
+    for (int j = from; j <= to; ++j) {
+      axpyRow(y + static_cast<size_t>(i) * res.stride(), a[j - from],
+              x.data() + static_cast<size_t>(j) * x.stride(), k);
+    }
+  }
+  return res;
+}
+
+S21Matrix S21TriangularMatrix::Solve(const S21Matrix& b) const {
+  checkOperand(_n, b);
+  const int k = b.getCol();
+  S21Matrix x(b);
+  double* xd = x.data();
+  auto row = [xd, &x](int i) {
+    return xd + static_cast<size_t>(i) * x.stride();
+  };
+  const bool lower = _uplo == S21Triangle::kLower;
+  for (int step = 0; step < _n; ++step) {
+    const int i = lower ? step : _n - 1 - step;
+    const int from = lower ? 0 : i + 1, to = lower ? i - 1 : _n - 1;
+    for (int j = from; j <= to; ++j) {
+      axpyRow(row(i), -_data[index(i, j)], row(j), k);
+    }
+    const double d = _data[index(i, i)];
+    if (d == 0) {
+      throw std::logic_error("Determinant = 0");
+    }
+    for (int c = 0; c < k; ++c) row(i)[c] /= d;
+  }
+  return x;
+}
+
+double S21TriangularMatrix::Determinant() const {
+  double res = 1;
+  for (int i = 0; i < _n; ++i) res *= _data[index(i, i)];
+  return res;
+}
+
+int S21TriangularMatrix::getSize() const { return _n; }
+
+S21Triangle S21TriangularMatrix::getTriangle() const { return _uplo; }
+
+// symmetric
+
+S21SymmetricMatrix::S21SymmetricMatrix(int n) : _n(n) {
+  checkSize(n);
+  _data.assign(static_cast<size_t>(n) * (n + 1) / 2, 0);
+}
+
+S21SymmetricMatrix::S21SymmetricMatrix(const S21Matrix& m)
+    : S21SymmetricMatrix(m.getRow()) {
+  checkSquare(m);
+  for (int i = 0; i < _n; ++i) {
+    for (int j = 0; j <= i; ++j) _data[index(i, j)] = m(i, j);
+  }
+}
+
+size_t S21SymmetricMatrix::index(int row, int col) const {
+  if (col > row) {
+    std::swap(row, col);
+  }
+  return static_cast<size_t>(row) * (row + 1) / 2 + col;
+}
+
+double& S21SymmetricMatrix::operator()(int row, int col) {
+  checkIndex(_n, row, col);
+  return _data[index(row, col)];
+}
+
+double S21SymmetricMatrix::operator()(int row, int col) const {
+  checkIndex(_n, row, col);
+  return _data[index(row, col)];
+}
+
+S21Matrix S21SymmetricMatrix::ToMatrix() const {
+  S21Matrix res(_n, _n);
+  for (int i = 0; i < _n; ++i) {
+    for (int j = 0; j <= i; ++j) {
+      res.at_unchecked(i, j) = res.at_unchecked(j, i) = _data[index(i, j)];
+    }
+  }
+  return res;
+}
+
+S21Matrix S21SymmetricMatrix::Mul(const S21Matrix& x) const {
+  checkOperand(_n, x);
+  const int k = x.getCol();
+  S21Matrix res(_n, k);
+  double* y = res.data();
+  auto out = [y, &res](int i) {
+    return y + static_cast<size_t>(i) * res.stride();
+  };
+  auto in = [&x](int i) {
+    return x.data() + static_cast<size_t>(i) * x.stride();
+  };
+  // a stored a(i, j) with j < i contributes to both y_i and y_j
+  for (int i = 0; i < _n; ++i) {
+    const double* a = _data.data() + index(i, 0);
+    for (int j = 0; j < i; ++j) {
+      axpyRow(out(i), a[j], in(j), k);
+      axpyRow(out(j), a[j], in(i), k);
+    }
+    axpyRow(out(i), a[i], in(i), k);
+  }
+  return res;
+}
+
+bool S21SymmetricMatrix::cholesky(std::vector<double>& l) const {
+  l = _data;
+  for (int i = 0; i < _n; ++i) {
+    double* li = l.data() + index(i, 0);
+    for (int j = 0; j <= i; ++j) {
+      const double* lj = l.data() + index(j, 0);
+      double s = li[j];
+      for (int p = 0; p < j; ++p) s -= li[p] * lj[p];
+      if (j < i) {
+        li[j] = s / lj[j];
+      } else if (s > 0) {
+        li[i] = std::sqrt(s);
+      } else {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool S21SymmetricMatrix::ldlt(std::vector<double>& f,
+                              std::vector<int>& pivots) const {
+  f = _data;
+  pivots.assign(_n, 0);
+  auto a = [this, &f](int i, int j) -> double& { return f[index(i, j)]; };
+  // Bunch-Kaufman bound on the growth of the elements
+  const double alpha = (1 + std::sqrt(17.0)) / 8;
+  std::vector<double> w0(_n), w1(_n);
+  bool regular = true;
+  for (int k = 0; k < _n;) {
+    // largest element below the diagonal in column k
+    int imax = k;
+    double colmax = 0;
+    for (int i = k + 1; i < _n; ++i) {
+      if (std::fabs(a(i, k)) > colmax) {
+        colmax = std::fabs(a(i, k));
+        imax = i;
+      }
+    }
+    const double absakk = std::fabs(a(k, k));
+    if (std::max(absakk, colmax) == 0) {
+      // zero column: D(k) = 0 and nothing to eliminate
+      regular = false;
+      pivots[k] = k;
+      ++k;
+      continue;
+    }
+    int step = 1, kp = k;
+    if (absakk < alpha * colmax) {
+      // largest element off the diagonal in row and column imax
+      double rowmax = 0;
+      for (int j = k; j < _n; ++j) {
+        if (j != imax) rowmax = std::max(rowmax, std::fabs(a(imax, j)));
+      }
+      if (absakk >= alpha * colmax * (colmax / rowmax)) {
+        kp = k;
+      } else if (std::fabs(a(imax, imax)) >= alpha * rowmax) {
+        kp = imax;
+      } else {
+        kp = imax;
+        step = 2;
+      }
+    }
+    // symmetric swap of rows and columns kk and kp of the trailing part
+    const int kk = k + step - 1;
+    if (kp != kk) {
+      for (int i = kp + 1; i < _n; ++i) std::swap(a(i, kk), a(i, kp));
+      for (int j = kk + 1; j < kp; ++j) std::swap(a(j, kk), a(kp, j));
+      std::swap(a(kk, kk), a(kp, kp));
+      if (step == 2) {
+        std::swap(a(k + 1, k), a(kp, k));
+      }
+    }
+    // the trailing update goes row by row over the packed rows, with the
+    // columns of L gathered first
+    if (step == 1) {
+      const double r = 1 / a(k, k);
+      for (int j = k + 1; j < _n; ++j) w0[j] = a(j, k);
+      for (int i = k + 1; i < _n; ++i) {
+        double* ai = f.data() + index(i, 0);
+        const double li = w0[i] * r;
+        for (int j = k + 1; j <= i; ++j) ai[j] -= li * w0[j];
+        ai[k] = li;
+      }
+      pivots[k] = kp;
+    } else {
+      const double d21 = a(k + 1, k);
+      const double d11 = a(k + 1, k + 1) / d21;
+      const double d22 = a(k, k) / d21;
+      const double t = 1 / (d11 * d22 - 1) / d21;
+      for (int j = k + 2; j < _n; ++j) {
+        w0[j] = t * (d11 * a(j, k) - a(j, k + 1));
+        w1[j] = t * (d22 * a(j, k + 1) - a(j, k));
+      }
+      for (int i = k + 2; i < _n; ++i) {
+        double* ai = f.data() + index(i, 0);
+        const double c0 = ai[k], c1 = ai[k + 1];
+        for (int j = k + 2; j <= i; ++j) ai[j] -= c0 * w0[j] + c1 * w1[j];
+        ai[k] = w0[i];
+        ai[k + 1] = w1[i];
+      }
+      pivots[k] = pivots[k + 1] = -(kp + 1);
+    }
+    k += step;
+  }
+  return regular;
+}
+
+S21Matrix S21SymmetricMatrix::Solve(const S21Matrix& b) const {
+  checkOperand(_n, b);
+  const int k = b.getCol();
+  S21Matrix x(b);
+  double* xd = x.data();
+  auto row = [xd, &x](int i) {
+    return xd + static_cast<size_t>(i) * x.stride();
+  };
+  std::vector<double> l;
+  if (!cholesky(l)) {
+    std::vector<int> pivots;
+    if (!ldlt(l, pivots)) {
+      throw std::logic_error("Determinant = 0");
+    }
+    auto swapRows = [&row, k](int i, int p) {
+      if (i != p) std::swap_ranges(row(i), row(i) + k, row(p));
+    };
+    // L * D * y = P * b, block by block
+    for (int j = 0; j < _n;) {
+      if (pivots[j] >= 0) {
+        swapRows(j, pivots[j]);
+        for (int i = j + 1; i < _n; ++i) {
+          axpyRow(row(i), -l[index(i, j)], row(j), k);
+        }
+        const double d = l[index(j, j)];
+        for (int c = 0; c < k; ++c) row(j)[c] /= d;
+        ++j;
+        continue;
+      }
+      swapRows(j + 1, -pivots[j] - 1);
+      for (int i = j + 2; i < _n; ++i) {
+        axpyRow(row(i), -l[index(i, j)], row(j), k);
+        axpyRow(row(i), -l[index(i, j + 1)], row(j + 1), k);
+      }
+      // the 2 x 2 block of D, scaled by its off-diagonal element
+      const double d21 = l[index(j + 1, j)];
+      const double e0 = l[index(j, j)] / d21;
+      const double e1 = l[index(j + 1, j + 1)] / d21;
+      const double denom = e0 * e1 - 1;
+      for (int c = 0; c < k; ++c) {
+        const double b0 = row(j)[c] / d21, b1 = row(j + 1)[c] / d21;
+        row(j)[c] = (e1 * b0 - b1) / denom;
+        row(j + 1)[c] = (e0 * b1 - b0) / denom;
+      }
+      j += 2;
+    }
+    // L^T * P * x = y, from the last block up
+    for (int j = _n - 1; j >= 0;) {
+      const int first = pivots[j] >= 0 ? j : j - 1;
+      for (int i = j + 1; i < _n; ++i) {
+        for (int q = first; q <= j; ++q) {
+          axpyRow(row(q), -l[index(i, q)], row(i), k);
+        }
+      }
+      swapRows(j, pivots[j] >= 0 ? pivots[j] : -pivots[j] - 1);
+      j = first - 1;
+    }
+    return x;
+  }
+  // L y = b by rows of L, then L^T x = y by the same rows as columns
+  for (int i = 0; i < _n; ++i) {
+    const double* li = l.data() + index(i, 0);
+    for (int p = 0; p < i; ++p) axpyRow(row(i), -li[p], row(p), k);
+    for (int c = 0; c < k; ++c) row(i)[c] /= li[i];
+  }
+  for (int i = _n - 1; i >= 0; --i) {
+    const double* li = l.data() + index(i, 0);
+    for (int c = 0; c < k; ++c) row(i)[c] /= li[i];
+    for (int p = 0; p < i; ++p) axpyRow(row(p), -li[p], row(i), k);
+  }
+  return x;
+}
+
+double S21SymmetricMatrix::Determinant() const {
+  std::vector<double> l;
+  if (!cholesky(l)) {
+    // the symmetric swaps leave the determinant as that of D
+    std::vector<int> pivots;
+    if (!ldlt(l, pivots)) {
+      return 0;
+    }
+    double res = 1;
+    for (int j = 0; j < _n; ++j) {
+      if (pivots[j] >= 0) {
+        res *= l[index(j, j)];
+      } else {
+        const double d21 = l[index(j + 1, j)];
+        res *= l[index(j, j)] * l[index(j + 1, j + 1)] - d21 * d21;
+        ++j;
+      }
+    }
+    return res;
+  }
+  double res = 1;
+  for (int i = 0; i < _n; ++i) res *= l[index(i, i)] * l[index(i, i)];
+  return res;
+}
+
+int S21SymmetricMatrix::getSize() const { return _n; }
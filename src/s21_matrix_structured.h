@@ -0,0 +1,117 @@
+#ifndef __S21MATRIX_STRUCTURED_H__
+#define __S21MATRIX_STRUCTURED_H__
+
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// packed storage for square matrices with known structure. Elements outside
+// the structure read as 0 (or mirror the stored half for symmetric
+// matrices) and cannot be written. Mul and Solve take and return n x k
+// S21Matrix blocks, so one call can handle several right-hand sides.
+
+// n x n matrix with `lower` diagonals below and `upper` above the main one,
+// stored row by row in n * (lower + upper + 1) elements. Solve and
+// Determinant use LU with partial pivoting in O(n * lower * (lower + upper))
+// time, which is O(n) for tridiagonal matrices.
+class S21BandMatrix {
+ private:
+  int _n, _lower, _upper;
+  std::vector<double> _data;  // element (i, j) at i * width + j - i + lower
+
+  int width() const { return _lower + _upper + 1; }
+  bool inBand(int row, int col) const {
+    return col - row <= _upper && row - col <= _lower;
+  }
+  // band LU of a copy with room for the fill-in caused by pivoting;
+  // returns false when a pivot is exactly zero
+  bool factor(std::vector<double>& lu, std::vector<int>& piv,
+              int& swaps) const;
+
+ public:
+  S21BandMatrix(int n, int lower, int upper);
+  // copies the band of a square matrix, everything outside is dropped
+  S21BandMatrix(const S21Matrix& m, int lower, int upper);
+
+  double& operator()(int row, int col);
+  double operator()(int row, int col) const;
+
+  S21Matrix ToMatrix() const;
+  S21Matrix Mul(const S21Matrix& x) const;    // *this * x
+  S21Matrix Solve(const S21Matrix& b) const;  // x such that *this * x = b
+  double Determinant() const;
+
+  int getSize() const;
+  int getLower() const;
+  int getUpper() const;
+};
+
+enum class S21Triangle { kLower, kUpper };
+
+// lower or upper triangular n x n matrix in n * (n + 1) / 2 elements
+class S21TriangularMatrix {
+ private:
+  int _n;
+  S21Triangle _uplo;
+  std::vector<double> _data;  // the rows of the triangle one after another
+
+  bool stored(int row, int col) const {
+    return _uplo == S21Triangle::kLower ? col <= row : col >= row;
+  }
+  size_t index(int row, int col) const;
+
+ public:
+  S21TriangularMatrix(int n, S21Triangle uplo);
+  // copies one triangle of a square matrix
+  S21TriangularMatrix(const S21Matrix& m, S21Triangle uplo);
+
+  double& operator()(int row, int col);
+  double operator()(int row, int col) const;
+
+  S21Matrix ToMatrix() const;
+  S21Matrix Mul(const S21Matrix& x) const;
+  // substitution in O(n^2) per right-hand side
+  S21Matrix Solve(const S21Matrix& b) const;
+  double Determinant() const;  // product of the diagonal
+
+  int getSize() const;
+  S21Triangle getTriangle() const;
+};
+
+// symmetric n x n matrix keeping only its lower triangle; writing (i, j)
+// also sets (j, i). Solve and Determinant use a packed Cholesky
+// factorisation and fall back to a packed Bunch-Kaufman L * D * L^T one
+// (symmetric pivoting, 1 x 1 and 2 x 2 blocks in D) when the matrix is not
+// positive definite; neither needs more than the packed triangle.
+class S21SymmetricMatrix {
+ private:
+  int _n;
+  std::vector<double> _data;  // lower triangle, row by row
+
+  size_t index(int row, int col) const;
+  // packed lower Cholesky factor; false if the matrix is not positive
+  // definite
+  bool cholesky(std::vector<double>& l) const;
+  // packed L and D of P * A * P^T = L * D * L^T, as LAPACK's dsptrf stores
+  // them: pivots[k] >= 0 is a 1 x 1 block swapped with row pivots[k],
+  // pivots[k] = pivots[k + 1] = -(p + 1) a 2 x 2 block whose second row was
+  // swapped with row p. False if the matrix is singular
+  bool ldlt(std::vector<double>& f, std::vector<int>& pivots) const;
+
+ public:
+  explicit S21SymmetricMatrix(int n);
+  // copies the lower triangle of a square matrix
+  explicit S21SymmetricMatrix(const S21Matrix& m);
+
+  double& operator()(int row, int col);
+  double operator()(int row, int col) const;
+
+  S21Matrix ToMatrix() const;
+  S21Matrix Mul(const S21Matrix& x) const;  // reads each element once
+  S21Matrix Solve(const S21Matrix& b) const;
+  double Determinant() const;
+
+  int getSize() const;
+};
+
+#endif
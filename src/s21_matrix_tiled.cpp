@@ -0,0 +1,560 @@
+#include "s21_matrix_tiled.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// tiles of size nb needed to cover n rows or columns
+int tileCount(int n, int nb) { return (n + nb - 1) / nb; }
+
+double dot(const double* x, const double* y, int n) {
+  double s = 0;
+  for (int p = 0; p < n; ++p) s += x[p] * y[p];
+  return s;
+}
+
+// an S21Matrix over a tile; tasks only read through views of const tiles
+S21Matrix view(const double* tile, int rows, int cols, int ld) {
+  return S21Matrix::Wrap(const_cast<double*>(tile), rows, cols, ld);
+}
+
+// c -= op(a) * op(b) on tile views
+void subtractProduct(S21Op op_a, const S21Matrix& a, S21Op op_b,
+                     const S21Matrix& b, S21Matrix c) {
+  c.Gemm(op_a, op_b, -1, a, b, 1);
+}
+
+// adds tasks to a graph with the edges implied by the tiles they use: a
+// task runs after the last writer of every tile it reads or writes, and a
+// writer also after the readers since the previous write
+class TileDeps {
+ private:
+  S21TaskGraph& _graph;
+  std::vector<int> _writer;
+  std::vector<std::vector<int>> _readers;
+
+ public:
+  TileDeps(S21TaskGraph& graph, int tiles)
+      : _graph(graph), _writer(tiles, -1), _readers(tiles) {}
+
+  void Add(std::function<void()> task, std::initializer_list<int> reads,
+           std::initializer_list<int> writes) {
+    std::vector<int> after;
+    for (int t : reads) {
+      if (_writer[t] >= 0) after.push_back(_writer[t]);
+    }
+    for (int t : writes) {
+      if (_writer[t] >= 0) after.push_back(_writer[t]);
+      after.insert(after.end(), _readers[t].begin(), _readers[t].end());
+    }
+    const int id = _graph.Add(std::move(task), after);
+    for (int t : reads) _readers[t].push_back(id);
+    for (int t : writes) {
+      _writer[t] = id;
+      _readers[t].clear();
+    }
+  }
+};
+
+// Cholesky factor of the lower triangle of the n x n tile a, in place;
+// false if a is not positive definite
+bool potrf(double* a, int lda, int n) {
+  for (int j = 0; j < n; ++j) {
+    double* aj = a + j * lda;
+    double d = aj[j] - dot(aj, aj, j);
+    if (!(d > 0)) {
+      return false;
+    }
+    aj[j] = d = std::sqrt(d);
+    for (int i = j + 1; i < n; ++i) {
+      double* ai = a + i * lda;
+      ai[j] = (ai[j] - dot(ai, aj, j)) / d;
+    }
+  }
+  return true;
+}
+
+// b = b * l^-T for the lower triangular n x n tile l and an m x n tile b
+void trsm(const double* l, int ldl, int n, double* b, int ldb, int m) {
+  for (int r = 0; r < m; ++r) {
+    double* x = b + r * ldb;
+    for (int j = 0; j < n; ++j) {
+      const double* lj = l + j * ldl;
+      x[j] = (x[j] - dot(x, lj, j)) / lj[j];
+    }
+  }
+}
+
+// x = l^-1 * x, or l^-T * x when trans, for the lower triangular n x n
+// tile l and an n x nc tile x
+void lowerSolve(const double* l, int ldl, int n, double* x, int ldx, int nc,
+                bool trans) {
+  if (!trans) {
+    for (int i = 0; i < n; ++i) {
+      const double* li = l + i * ldl;
+      double* xi = x + i * ldx;
+      for (int p = 0; p < i; ++p) {
+        const double* xp = x + p * ldx;
+        for (int c = 0; c < nc; ++c) xi[c] -= li[p] * xp[c];
+      }
+      for (int c = 0; c < nc; ++c) xi[c] /= li[i];
+    }
+    return;
+  }
+  for (int i = n - 1; i >= 0; --i) {
+    const double* li = l + i * ldl;
+    double* xi = x + i * ldx;
+    for (int c = 0; c < nc; ++c) xi[c] /= li[i];
+    for (int p = 0; p < i; ++p) {
+      double* xp = x + p * ldx;
+      for (int c = 0; c < nc; ++c) xp[c] -= li[p] * xi[c];
+    }
+  }
+}
+
+// x = r^-1 * x for the upper triangular n x n tile r and an n x nc tile x
+void upperSolve(const double* r, int ldr, int n, double* x, int ldx, int nc) {
+  for (int i = n - 1; i >= 0; --i) {
+    const double* ri = r + i * ldr;
+    double* xi = x + i * ldx;
+    for (int p = i + 1; p < n; ++p) {
+      const double* xp = x + p * ldx;
+      for (int c = 0; c < nc; ++c) xi[c] -= ri[p] * xp[c];
+    }
+    for (int c = 0; c < nc; ++c) xi[c] /= ri[i];
+  }
+}
+
+// Householder reflector I - tau * v * v^T with v = (1, x * scale) that maps
+// (alpha, x) onto (beta, 0); alpha becomes beta. xnorm2 is |x|^2, and tau
+// is 0 (no reflection) when x is already zero.
+double reflector(double& alpha, double xnorm2, double& scale) {
+  if (xnorm2 == 0) {
+    scale = 0;
+    return 0;
+  }
+  const double beta = -std::copysign(std::sqrt(alpha * alpha + xnorm2), alpha);
+  const double tau = (beta - alpha) / beta;
+  scale = 1 / (alpha - beta);
+  alpha = beta;
+  return tau;
+}
+
+// QR of the m x n tile a (m >= n): R on and above the diagonal, the
+// reflectors below it
+void geqrt(double* a, int lda, int m, int n, double* tau) {
+  std::vector<double> w(n);
+  for (int j = 0; j < n; ++j) {
+    double norm2 = 0, scale;
+    for (int i = j + 1; i < m; ++i) norm2 += a[i * lda + j] * a[i * lda + j];
+    tau[j] = reflector(a[j * lda + j], norm2, scale);
+    if (tau[j] == 0) continue;
+    for (int i = j + 1; i < m; ++i) a[i * lda + j] *= scale;
+    // w = v^T * a over the columns right of j
+    std::copy(a + j * lda + j + 1, a + j * lda + n, w.begin());
+    for (int i = j + 1; i < m; ++i) {
+      const double* ai = a + i * lda;
+      for (int c = j + 1; c < n; ++c) w[c - j - 1] += ai[j] * ai[c];
+    }
+    for (int c = j + 1; c < n; ++c) a[j * lda + c] -= tau[j] * w[c - j - 1];
+    for (int i = j + 1; i < m; ++i) {
+      double* ai = a + i * lda;
+      for (int c = j + 1; c < n; ++c) ai[c] -= tau[j] * ai[j] * w[c - j - 1];
+    }
+  }
+}
+
+// applies the k reflectors stored below the diagonal of the m-row tile v to
+// the m x nc tile c: c = Q^T * c
+void unmqr(const double* v, int ldv, int m, int k, const double* tau,
+           double* c, int ldc, int nc) {
+  std::vector<double> w(nc);
+  for (int j = 0; j < k; ++j) {
+    if (tau[j] == 0) continue;
+    std::copy(c + j * ldc, c + j * ldc + nc, w.begin());
+    for (int i = j + 1; i < m; ++i) {
+      const double vi = v[i * ldv + j];
+      const double* ci = c + i * ldc;
+      for (int q = 0; q < nc; ++q) w[q] += vi * ci[q];
+    }
+    for (int q = 0; q < nc; ++q) c[j * ldc + q] -= tau[j] * w[q];
+    for (int i = j + 1; i < m; ++i) {
+      const double t = tau[j] * v[i * ldv + j];
+      double* ci = c + i * ldc;
+      for (int q = 0; q < nc; ++q) ci[q] -= t * w[q];
+    }
+  }
+}
+
+// QR of the upper triangular n x n tile r stacked on the m x n tile a; r
+// gets the new R and a the lower parts of the reflectors, whose upper parts
+// are unit vectors
+void tsqrt(double* r, int ldr, int n, double* a, int lda, int m,
+           double* tau) {
+  std::vector<double> w(n);
+  for (int j = 0; j < n; ++j) {
+    double norm2 = 0, scale;
+    for (int i = 0; i < m; ++i) norm2 += a[i * lda + j] * a[i * lda + j];
+    tau[j] = reflector(r[j * ldr + j], norm2, scale);
+    if (tau[j] == 0) continue;
+    for (int i = 0; i < m; ++i) a[i * lda + j] *= scale;
+    std::copy(r + j * ldr + j + 1, r + j * ldr + n, w.begin());
+    for (int i = 0; i < m; ++i) {
+      const double* ai = a + i * lda;
+      for (int c = j + 1; c < n; ++c) w[c - j - 1] += ai[j] * ai[c];
+    }
+    for (int c = j + 1; c < n; ++c) r[j * ldr + c] -= tau[j] * w[c - j - 1];
+    for (int i = 0; i < m; ++i) {
+      double* ai = a + i * lda;
+      for (int c = j + 1; c < n; ++c) ai[c] -= tau[j] * ai[j] * w[c - j - 1];
+    }
+  }
+}
+
+// applies the k reflectors of tsqrt, kept in the m-row tile v, to the first
+// k rows of c1 stacked on the m x nc tile c2
+void tsmqr(const double* v, int ldv, int m, int k, const double* tau,
+           double* c1, int ldc1, double* c2, int ldc2, int nc) {
+  std::vector<double> w(nc);
+  for (int j = 0; j < k; ++j) {
+    if (tau[j] == 0) continue;
+    std::copy(c1 + j * ldc1, c1 + j * ldc1 + nc, w.begin());
+    for (int i = 0; i < m; ++i) {
+      const double vi = v[i * ldv + j];
+      const double* ci = c2 + i * ldc2;
+      for (int q = 0; q < nc; ++q) w[q] += vi * ci[q];
+    }
+    for (int q = 0; q < nc; ++q) c1[j * ldc1 + q] -= tau[j] * w[q];
+    for (int i = 0; i < m; ++i) {
+      const double t = tau[j] * v[i * ldv + j];
+      double* ci = c2 + i * ldc2;
+      for (int q = 0; q < nc; ++q) ci[q] -= t * w[q];
+    }
+  }
+}
+
+void checkTile(int tile) {
+  if (tile <= 0) {
+    throw std::invalid_argument("Wrong size of tile");
+  }
+}
+
+}  // namespace
+
+S21Cholesky::S21Cholesky(const S21Matrix& a, int tile, S21Executor* executor)
+    : _tile(tile), _executor(executor) {
+  if (a.getRow() != a.getCol()) {
+    throw std::invalid_argument("Matrix is not sqared");
+  }
+  if (a.getRow() <= 0) {
+    throw std::invalid_argument("Wrong size of matrix");
+  }
+  checkTile(tile);
+  _l = a;
+  const int n = getSize(), nt = tileCount(n, tile);
+  const int ld = _l.stride();
+  double* base = _l.data();
+  auto at = [=](int i, int j) {
+    return base + static_cast<size_t>(i) * tile * ld + j * tile;
+  };
+  auto size = [=](int i) { return std::min(tile, n - i * tile); };
+  S21TaskGraph graph;
+  TileDeps deps(graph, nt * nt);
+  for (int k = 0; k < nt; ++k) {
+    deps.Add(
+        [=] {
+          if (!potrf(at(k, k), ld, size(k))) {
+            throw std::logic_error("Matrix is not positive definite");
+          }
+        },
+        {}, {k * nt + k});
+    for (int i = k + 1; i < nt; ++i) {
+      deps.Add([=] { trsm(at(k, k), ld, size(k), at(i, k), ld, size(i)); },
+               {k * nt + k}, {i * nt + k});
+    }
+    // trailing update of the lower triangle, diagonal tiles included
+    for (int i = k + 1; i < nt; ++i) {
+      for (int j = k + 1; j <= i; ++j) {
+        deps.Add(
+            [=] {
+              subtractProduct(S21Op::kNoTrans,
+                              view(at(i, k), size(i), size(k), ld),
+                              S21Op::kTrans,
+                              view(at(j, k), size(j), size(k), ld),
+                              view(at(i, j), size(i), size(j), ld));
+            },
+            {i * nt + k, j * nt + k}, {i * nt + j});
+      }
+    }
+  }
+  graph.Run(_executor);
+  for (int i = 0; i < n; ++i) {
+    std::fill(base + static_cast<size_t>(i) * ld + i + 1,
+              base + static_cast<size_t>(i) * ld + n, 0.0);
+  }
+}
+
+S21Matrix S21Cholesky::Solve(const S21Matrix& b) const {
+  const int n = getSize(), tile = _tile;
+  if (b.getRow() != n) {
+    throw std::invalid_argument("Wrong size of matrixes");
+  }
+  const int nt = tileCount(n, tile), ct = tileCount(b.getCol(), tile);
+  S21Matrix x(b);
+  const int ld = _l.stride(), ldx = x.stride(), cols = x.getCol();
+  const double* base = _l.data();
+  double* xbase = x.data();
+  auto at = [=](int i, int j) {
+    return base + static_cast<size_t>(i) * tile * ld + j * tile;
+  };
+  auto xat = [=](int i, int c) {
+    return xbase + static_cast<size_t>(i) * tile * ldx + c * tile;
+  };
+  auto size = [=](int i) { return std::min(tile, n - i * tile); };
+  auto width = [=](int c) { return std::min(tile, cols - c * tile); };
+  S21TaskGraph graph;
+  TileDeps deps(graph, nt * ct);
+  // L * y = b, then L^T * x = y; the blocks of columns are independent
+  for (int k = 0; k < nt; ++k) {
+    for (int c = 0; c < ct; ++c) {
+      deps.Add(
+          [=] {
+            lowerSolve(at(k, k), ld, size(k), xat(k, c), ldx, width(c), false);
+          },
+          {}, {k * ct + c});
+      for (int i = k + 1; i < nt; ++i) {
+        deps.Add(
+            [=] {
+              subtractProduct(S21Op::kNoTrans,
+                              view(at(i, k), size(i), size(k), ld),
+                              S21Op::kNoTrans,
+                              view(xat(k, c), size(k), width(c), ldx),
+                              view(xat(i, c), size(i), width(c), ldx));
+            },
+            {k * ct + c}, {i * ct + c});
+      }
+    }
+  }
+  for (int k = nt - 1; k >= 0; --k) {
+    for (int c = 0; c < ct; ++c) {
+      deps.Add(
+          [=] {
+            lowerSolve(at(k, k), ld, size(k), xat(k, c), ldx, width(c), true);
+          },
+          {}, {k * ct + c});
+      for (int i = 0; i < k; ++i) {
+        deps.Add(
+            [=] {
+              subtractProduct(S21Op::kTrans,
+                              view(at(k, i), size(k), size(i), ld),
+                              S21Op::kNoTrans,
+                              view(xat(k, c), size(k), width(c), ldx),
+                              view(xat(i, c), size(i), width(c), ldx));
+            },
+            {k * ct + c}, {i * ct + c});
+      }
+    }
+  }
+  graph.Run(_executor);
+  return x;
+}
+
+double S21Cholesky::Determinant() const {
+  return std::exp(LogDeterminant());
+}
+
+double S21Cholesky::LogDeterminant() const {
+  double log_det = 0;
+  for (int i = 0; i < getSize(); ++i) log_det += 2 * std::log(_l(i, i));
+  return log_det;
+}
+
+const S21Matrix& S21Cholesky::getL() const { return _l; }
+
+int S21Cholesky::getSize() const { return _l.getRow(); }
+
+int S21Cholesky::getTile() const { return _tile; }
+
+S21QR::S21QR(const S21Matrix& a, int tile, S21Executor* executor)
+    : _tile(tile), _executor(executor) {
+  if (a.getRow() <= 0 || a.getRow() < a.getCol()) {
+    throw std::invalid_argument("Wrong size of matrix");
+  }
+  checkTile(tile);
+  _qr = a;
+  const int m = getRow(), n = getCol();
+  const int mt = rowTiles(), nt = colTiles();
+  _tau.assign(static_cast<size_t>(mt) * nt * tile, 0);
+  const int ld = _qr.stride();
+  double* base = _qr.data();
+  double* taus = _tau.data();
+  auto at = [=](int i, int j) {
+    return base + static_cast<size_t>(i) * tile * ld + j * tile;
+  };
+  auto tau = [=](int i, int j) {
+    return taus + (static_cast<size_t>(i) * nt + j) * tile;
+  };
+  auto rows = [=](int i) { return std::min(tile, m - i * tile); };
+  auto cols = [=](int j) { return std::min(tile, n - j * tile); };
+  S21TaskGraph graph;
+  TileDeps deps(graph, mt * nt);
+  for (int k = 0; k < nt; ++k) {
+    // the diagonal tile has at least as many rows as columns since m >= n
+    deps.Add([=] { geqrt(at(k, k), ld, rows(k), cols(k), tau(k, k)); }, {},
+             {k * nt + k});
+    for (int j = k + 1; j < nt; ++j) {
+      deps.Add(
+          [=] {
+            unmqr(at(k, k), ld, rows(k), cols(k), tau(k, k), at(k, j), ld,
+                  cols(j));
+          },
+          {k * nt + k}, {k * nt + j});
+    }
+    // the tiles below the diagonal are eliminated one after another
+    // against the R of the diagonal tile
+    for (int i = k + 1; i < mt; ++i) {
+      deps.Add(
+          [=] {
+            tsqrt(at(k, k), ld, cols(k), at(i, k), ld, rows(i), tau(i, k));
+          },
+          {}, {k * nt + k, i * nt + k});
+      for (int j = k + 1; j < nt; ++j) {
+        deps.Add(
+            [=] {
+              tsmqr(at(i, k), ld, rows(i), cols(k), tau(i, k), at(k, j), ld,
+                    at(i, j), ld, cols(j));
+            },
+            {i * nt + k}, {k * nt + j, i * nt + j});
+      }
+    }
+  }
+  graph.Run(_executor);
+}
+
+int S21QR::rowTiles() const { return tileCount(getRow(), _tile); }
+
+int S21QR::colTiles() const { return tileCount(getCol(), _tile); }
+
+S21Matrix S21QR::Solve(const S21Matrix& b) const {
+  const int m = getRow(), n = getCol(), tile = _tile;
+  if (b.getRow() != m) {
+    throw std::invalid_argument("Wrong size of matrixes");
+  }
+  for (int j = 0; j < n; ++j) {
+    if (_qr(j, j) == 0) {
+      throw std::logic_error("Determinant = 0");
+    }
+  }
+  const int mt = rowTiles(), nt = colTiles(), ct = tileCount(b.getCol(), tile);
+  S21Matrix x(b);
+  const int ld = _qr.stride(), ldx = x.stride(), width_all = x.getCol();
+  const double* base = _qr.data();
+  const double* taus = _tau.data();
+  double* xbase = x.data();
+  auto at = [=](int i, int j) {
+    return base + static_cast<size_t>(i) * tile * ld + j * tile;
+  };
+  auto tau = [=](int i, int j) {
+    return taus + (static_cast<size_t>(i) * nt + j) * tile;
+  };
+  auto xat = [=](int i, int c) {
+    return xbase + static_cast<size_t>(i) * tile * ldx + c * tile;
+  };
+  auto rows = [=](int i) { return std::min(tile, m - i * tile); };
+  auto cols = [=](int j) { return std::min(tile, n - j * tile); };
+  auto width = [=](int c) { return std::min(tile, width_all - c * tile); };
+  S21TaskGraph graph;
+  TileDeps deps(graph, mt * ct);
+  // y = Q^T * b with the reflectors in the order they were made
+  for (int k = 0; k < nt; ++k) {
+    for (int c = 0; c < ct; ++c) {
+      deps.Add(
+          [=] {
+            unmqr(at(k, k), ld, rows(k), cols(k), tau(k, k), xat(k, c), ldx,
+                  width(c));
+          },
+          {}, {k * ct + c});
+      for (int i = k + 1; i < mt; ++i) {
+        deps.Add(
+            [=] {
+              tsmqr(at(i, k), ld, rows(i), cols(k), tau(i, k), xat(k, c), ldx,
+                    xat(i, c), ldx, width(c));
+            },
+            {}, {k * ct + c, i * ct + c});
+      }
+    }
+  }
+  // R * x = the first n rows of y
+  for (int k = nt - 1; k >= 0; --k) {
+    for (int c = 0; c < ct; ++c) {
+      deps.Add(
+          [=] {
+            upperSolve(at(k, k), ld, cols(k), xat(k, c), ldx, width(c));
+          },
+          {}, {k * ct + c});
+      for (int i = 0; i < k; ++i) {
+        deps.Add(
+            [=] {
+              subtractProduct(S21Op::kNoTrans,
+                              view(at(i, k), cols(i), cols(k), ld),
+                              S21Op::kNoTrans,
+                              view(xat(k, c), cols(k), width(c), ldx),
+                              view(xat(i, c), cols(i), width(c), ldx));
+            },
+            {k * ct + c}, {i * ct + c});
+      }
+    }
+  }
+  graph.Run(_executor);
+  S21Matrix res(n, width_all);
+  double* out = res.data();
+  for (int i = 0; i < n; ++i) {
+    std::copy(xbase + static_cast<size_t>(i) * ldx,
+              xbase + static_cast<size_t>(i) * ldx + width_all,
+              out + static_cast<size_t>(i) * res.stride());
+  }
+  return res;
+}
+
+double S21QR::Determinant() const {
+  int sign;
+  const double log_det = LogDeterminant(&sign);
+  return sign * std::exp(log_det);
+}
+
+double S21QR::LogDeterminant(int* sign) const {
+  if (getRow() != getCol()) {
+    throw std::invalid_argument("Matrix is not sqared");
+  }
+  double log_det = 0;
+  int s = 1;
+  for (int j = 0; j < getCol(); ++j) {
+    const double r = _qr(j, j);
+    log_det += std::log(std::fabs(r));
+    s = r < 0 ? -s : r > 0 ? s : 0;
+  }
+  // every reflector that is applied has determinant -1
+  for (double t : _tau) {
+    if (t != 0) s = -s;
+  }
+  if (sign) {
+    *sign = s;
+  }
+  return log_det;
+}
+
+S21Matrix S21QR::getR() const {
+  const int n = getCol();
+  S21Matrix r(n, n);
+  for (int i = 0; i < n; ++i) {
+    for (int j = i; j < n; ++j) r(i, j) = _qr(i, j);
+  }
+  return r;
+}
+
+int S21QR::getRow() const { return _qr.getRow(); }
+
+int S21QR::getCol() const { return _qr.getCol(); }
+
+int S21QR::getTile() const { return _tile; }
@@ -0,0 +1,74 @@
+#ifndef __S21MATRIX_TILED_H__
+#define __S21MATRIX_TILED_H__
+
+#include <vector>
+
+#include "s21_executor.h"
+#include "s21_matrix_oop.h"
+
+// factorisations computed on square tiles of an S21Matrix. Each panel and
+// update step on a tile is one task of an S21TaskGraph, so the steps of
+// different panels overlap as soon as the tiles they need are ready; the
+// tile products go through S21Matrix::Gemm and use BLAS in BACKEND=blas
+// builds. Edge tiles may be smaller than the tile size. The objects keep
+// the factors, so one factorisation serves any number of Solve calls; the
+// executor given to the constructor runs those too and must outlive the
+// object (nullptr runs everything on the calling thread).
+
+// A = L * L^T for a symmetric positive definite A; only the lower triangle
+// of A is read
+class S21Cholesky {
+ private:
+  S21Matrix _l;  // lower triangular, zero above the diagonal
+  int _tile;
+  S21Executor* _executor;
+
+ public:
+  static const int kDefaultTile = 256;
+
+  explicit S21Cholesky(const S21Matrix& a, int tile = kDefaultTile,
+                       S21Executor* executor = nullptr);
+
+  S21Matrix Solve(const S21Matrix& b) const;  // x such that A * x = b
+  // both are accumulated as a sum of logarithms, so no intermediate product
+  // overflows; Determinant is only infinite or zero when det A is
+  double Determinant() const;
+  double LogDeterminant() const;  // log det A, finite for any factorised A
+
+  const S21Matrix& getL() const;
+  int getSize() const;
+  int getTile() const;
+};
+
+// A = Q * R for an m x n matrix with m >= n by Householder reflectors;
+// Solve returns the least-squares solution when m > n
+class S21QR {
+ private:
+  S21Matrix _qr;  // R on and above the diagonal, the reflectors below it
+  std::vector<double> _tau;  // scales of the reflectors, per tile
+  int _tile;
+  S21Executor* _executor;
+
+  int rowTiles() const;
+  int colTiles() const;
+
+ public:
+  static const int kDefaultTile = 256;
+
+  explicit S21QR(const S21Matrix& a, int tile = kDefaultTile,
+                 S21Executor* executor = nullptr);
+
+  S21Matrix Solve(const S21Matrix& b) const;  // minimises |A * x - b|
+  // square matrices only; both are accumulated as a sum of logarithms.
+  // LogDeterminant returns log |det A| and stores the sign of det A, or 0
+  // for a singular A, in sign when it is given
+  double Determinant() const;
+  double LogDeterminant(int* sign = nullptr) const;
+
+  S21Matrix getR() const;  // n x n upper triangular
+  int getRow() const;
+  int getCol() const;
+  int getTile() const;
+};
+
+#endif
@@ -0,0 +1,183 @@
+#include "s21_numa.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <climits>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+
+#include "s21_executor.h"
+#include "s21_matrix_oop.h"
+
+namespace {
+
+std::atomic<S21Placement> placement{S21Placement::kDefault};
+
+// buffers from this size on are mapped directly, so none of their pages is
+// touched before the placement policy is applied
+const size_t kNumaBytes = 1 << 20;
+// pages faulted in by one worker at a time during first-touch initialisation
+const int kTouchGrain = 64;
+
+// memory policies from <numaif.h>
+const int kMpolPreferred = 1;
+const int kMpolInterleave = 3;
+
+// parses sysfs lists such as "0-3,8-11"
+std::vector<int> readList(const std::string& path) {
+  std::vector<int> res;
+  std::ifstream in(path);
+  std::string item;
+  while (std::getline(in, item, ',')) {
+    std::istringstream range(item);
+    int from, to;
+    if (!(range >> from)) {
+      continue;
+    }
+    to = from;
+    if (range.peek() == '-') {
+      range.ignore();
+      range >> to;
+    }
+    for (int i = from; i <= to; ++i) res.push_back(i);
+  }
+  return res;
+}
+
+const std::vector<int>& nodes() {
+  static const std::vector<int> list = [] {
+    std::vector<int> res = readList("/sys/devices/system/node/online");
+    if (res.empty()) {
+      res.push_back(0);
+    }
+    return res;
+  }();
+  return list;
+}
+
+// failures (kernel without NUMA, restricted containers) keep the default
+// policy, which is the right fallback anyway
+void bind(void* addr, size_t len, int mode, const std::vector<int>& on) {
+  const size_t bits = sizeof(unsigned long) * CHAR_BIT;
+  std::vector<unsigned long> mask(nodes().back() / bits + 1, 0);
+  for (int node : on) mask[node / bits] |= 1UL << (node % bits);
+  syscall(SYS_mbind, addr, len, mode, mask.data(), mask.size() * bits + 1, 0);
+}
+
+}  // namespace
+
+int s21NumaNodes() { return static_cast<int>(nodes().size()); }
+
+const std::vector<int>& s21NumaCpus() {
+  static const std::vector<int> list = [] {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    sched_getaffinity(0, sizeof(allowed), &allowed);
+    std::vector<std::vector<int>> perNode;
+    for (int node : nodes()) {
+      perNode.push_back(readList("/sys/devices/system/node/node" +
+                                 std::to_string(node) + "/cpulist"));
+    }
+    std::vector<int> res;
+    cpu_set_t seen;
+    CPU_ZERO(&seen);
+    size_t longest = 0;
+    for (const std::vector<int>& cpus : perNode) {
+      longest = std::max(longest, cpus.size());
+    }
+    for (size_t k = 0; k < longest; ++k) {
+      for (const std::vector<int>& cpus : perNode) {
+        if (k < cpus.size() && cpus[k] < CPU_SETSIZE &&
+            CPU_ISSET(cpus[k], &allowed) && !CPU_ISSET(cpus[k], &seen)) {
+          res.push_back(cpus[k]);
+          CPU_SET(cpus[k], &seen);
+        }
+      }
+    }
+    // no sysfs topology: keep the allowed CPUs in numeric order
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &allowed) && !CPU_ISSET(cpu, &seen)) {
+        res.push_back(cpu);
+      }
+    }
+    return res;
+  }();
+  return list;
+}
+
+bool s21PinThread(std::thread& thread, int cpu) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) ==
+         0;
+}
+
+double* s21AllocBuffer(size_t n) {
+  const size_t bytes = n * sizeof(double);
+  if (bytes < kNumaBytes) {
+    return new double[n]();
+  }
+  // anonymous pages read as zero and are only placed once written
+  void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+  char* base = static_cast<char*>(p);
+  const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  switch (S21Matrix::getPlacement()) {
+    case S21Placement::kFirstTouch: {
+      // each page lands on the node of the pinned worker that writes it
+      // first; the static split of the pinned executor hands the same
+      // blocks of rows to the same workers when they compute on them. A
+      // pinned worker allocating touches every page itself
+      const int pages = static_cast<int>((bytes + page - 1) / page);
+      S21Executor::Pinned().ParallelFor(
+          0, pages, kTouchGrain, [base, page](int from, int to) {
+            for (int i = from; i < to; ++i) base[i * page] = 0;
+          });
+      break;
+    }
+    case S21Placement::kInterleave:
+      bind(p, bytes, kMpolInterleave, nodes());
+      break;
+    case S21Placement::kBlocked: {
+      // consecutive row blocks go to consecutive nodes, page aligned
+      const size_t count = nodes().size();
+      for (size_t k = 0; k < count; ++k) {
+        size_t from = bytes * k / count / page * page;
+        size_t to = bytes * (k + 1) / count / page * page;
+        if (k + 1 == count) {
+          to = bytes;
+        }
+        if (to > from) {
+          bind(base + from, to - from, kMpolPreferred, {nodes()[k]});
+        }
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  return static_cast<double*>(p);
+}
+
+void s21FreeBuffer(double* p, size_t n) {
+  if (n * sizeof(double) < kNumaBytes) {
+    delete[] p;
+  } else if (p) {
+    munmap(p, n * sizeof(double));
+  }
+}
+
+void S21Matrix::setPlacement(S21Placement p) { placement = p; }
+
+S21Placement S21Matrix::getPlacement() { return placement; }
@@ -0,0 +1,25 @@
+#ifndef __S21NUMA_H__
+#define __S21NUMA_H__
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// NUMA helpers behind S21Matrix buffers and pinned S21Executor workers; the
+// topology is read from sysfs and placement uses the raw mbind syscall, so
+// nothing extra is linked and machines without NUMA see a single node
+
+// number of memory nodes, at least 1
+int s21NumaNodes();
+// CPUs the process may run on, taken from the nodes in turn so consecutive
+// entries alternate between nodes
+const std::vector<int>& s21NumaCpus();
+// binds the thread to one CPU; false if the system refused
+bool s21PinThread(std::thread& thread, int cpu);
+
+// zero-initialised storage for n doubles placed according to
+// S21Matrix::getPlacement; release it with s21FreeBuffer(p, n)
+double* s21AllocBuffer(size_t n);
+void s21FreeBuffer(double* p, size_t n);
+
+#endif
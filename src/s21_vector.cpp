@@ -0,0 +1,196 @@
+#include "s21_vector.h"
+
+#include "s21_blas.h"
+
+namespace {
+
+// rows or columns handed to a thread at a time cover at least this many
+// matrix elements
+const int kParallelGrain = 1 << 16;
+// independent accumulators, so a dot product is not one serial chain
+const int kLanes = 4;
+
+double dot(const double* x, const double* y, int n) {
+  double acc[kLanes] = {0, 0, 0, 0};
+  int j = 0;
+  for (; j + kLanes <= n; j += kLanes) {
+    for (int l = 0; l < kLanes; ++l) acc[l] += x[j + l] * y[j + l];
+  }
+  double res = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+  for (; j < n; ++j) res += x[j] * y[j];
+  return res;
+}
+
+inline void axpy(double* y, double alpha, const double* x, int n) {
+  for (int j = 0; j < n; ++j) y[j] += alpha * x[j];
+}
+
+// runs body over [0, count) on the executor, or inline without one; the
+// inline path does not wrap body in a std::function, so it never allocates
+template <class F>
+void run(S21Executor* executor, int count, int work_per_item, F body) {
+  if (executor) {
+    executor->ParallelFor(0, count,
+                          std::max(1, kParallelGrain / work_per_item), body);
+  } else {
+    body(0, count);
+  }
+}
+
+void checkSize(int size) {
+  if (size <= 0) {
+    throw std::invalid_argument("Wrong size of vector");
+  }
+}
+
+}  // namespace
+
+S21Vector::S21Vector(int size) {
+  checkSize(size);
+  _data.assign(size, 0);
+}
+
+S21Vector::S21Vector(std::initializer_list<double> values) : _data(values) {}
+
+S21Vector::S21Vector(const S21Matrix& m) {
+  if (m.getRow() != 1 && m.getCol() != 1) {
+    throw std::invalid_argument("Wrong size of vector");
+  }
+  const bool column = m.getCol() == 1;
+  _data.resize(column ? m.getRow() : m.getCol());
+  for (int i = 0; i < getSize(); ++i) {
+    _data[i] = column ? m.at_unchecked(i, 0) : m.at_unchecked(0, i);
+  }
+}
+
+double& S21Vector::operator()(int i) {
+  if (i < 0 || i >= getSize()) {
+    throw std::out_of_range("Incorrect input, index is out of range");
+  }
+  return _data[i];
+}
+
+double S21Vector::operator()(int i) const {
+  if (i < 0 || i >= getSize()) {
+    throw std::out_of_range("Incorrect input, index is out of range");
+  }
+  return _data[i];
+}
+
+int S21Vector::getSize() const { return static_cast<int>(_data.size()); }
+
+void S21Vector::setSize(int size) {
+  checkSize(size);
+  _data.resize(size, 0);
+}
+
+S21Matrix S21Vector::ToMatrix() const {
+  S21Matrix res(getSize(), 1);
+  std::copy(_data.begin(), _data.end(), res.data());
+  return res;
+}
+
+bool S21Vector::EqVector(const S21Vector& o, const S21Tolerance& tol) const {
+  if (getSize() != o.getSize()) {
+    return false;
+  }
+  if (_data.empty()) {
+    return true;
+  }
+  // the views are only read by Compare
+  S21Matrix a = S21Matrix::Wrap(const_cast<double*>(data()), 1, getSize());
+  S21Matrix b = S21Matrix::Wrap(const_cast<double*>(o.data()), 1, getSize());
+  return a.Compare(b, tol).equal;
+}
+
+void S21Vector::Gemv(S21Op op, double alpha, const S21Matrix& a,
+                     const S21Vector& x, double beta, S21Executor* executor) {
+  const bool trans = op == S21Op::kTrans;
+  const int rows = a.getRow(), cols = a.getCol();
+  const int m = trans ? cols : rows, n = trans ? rows : cols;
+  if (x.getSize() != n) {
+    throw std::invalid_argument("Wrong size of matrixes");
+  }
+  if (beta != 0 && getSize() != m) {
+    throw std::invalid_argument("Different size of vector");
+  }
+  if (this == &x) {
+    S21Vector copy(x);
+    Gemv(op, alpha, a, copy, beta, executor);
+    return;
+  }
+  if (getSize() != m) {
+    _data.assign(m, 0);
+  }
+  double* y = data();
+  const double* xd = x.data();
+  const double* ad = a.data();
+  const size_t lda = a.stride();
+#ifdef S21_USE_BLAS
+  if (S21Matrix::getBackend() == S21Backend::kBlas) {
+    cblas_dgemv(CblasRowMajor, trans ? CblasTrans : CblasNoTrans, rows, cols,
+                alpha, ad, a.stride(), xd, 1, beta, y, 1);
+    return;
+  }
+#endif
+  if (!trans) {
+    // one dot product per row; rows are split between threads
+    run(executor, m, n, [=](int from, int to) {
+      for (int i = from; i < to; ++i) {
+        const double s = alpha * dot(ad + i * lda, xd, n);
+        y[i] = beta == 0 ? s : s + beta * y[i];
+      }
+    });
+  } else {
+    // y += alpha * x_i * row i for every row; each thread owns a segment
+    // of y, so the rows are streamed without merging partial sums
+    run(executor, m, n, [=](int from, int to) {
+      for (int j = from; j < to; ++j) y[j] = beta == 0 ? 0 : beta * y[j];
+      for (int i = 0; i < n; ++i) {
+        axpy(y + from, alpha * xd[i], ad + i * lda + from, to - from);
+      }
+    });
+  }
+}
+
+void S21Vector::Axpy(double alpha, const S21Vector& x) {
+  if (x.getSize() != getSize()) {
+    throw std::invalid_argument("Different size of vector");
+  }
+#ifdef S21_USE_BLAS
+  if (S21Matrix::getBackend() == S21Backend::kBlas) {
+    cblas_daxpy(getSize(), alpha, x.data(), 1, data(), 1);
+    return;
+  }
+#endif
+  axpy(data(), alpha, x.data(), getSize());
+}
+
+double S21Vector::Dot(const S21Vector& o) const {
+  if (o.getSize() != getSize()) {
+    throw std::invalid_argument("Different size of vector");
+  }
+  return dot(data(), o.data(), getSize());
+}
+
+double S21Vector::Norm() const { return std::sqrt(Dot(*this)); }
+
+void S21Matrix::Ger(double alpha, const S21Vector& x, const S21Vector& y,
+                    S21Executor* executor) {
+  if (x.getSize() != _rows || y.getSize() != _cols) {
+    throw std::invalid_argument("Wrong size of matrixes");
+  }
+  makeUnique();
+#ifdef S21_USE_BLAS
+  if (getBackend() == S21Backend::kBlas) {
+    cblas_dger(CblasRowMajor, _rows, _cols, alpha, x.data(), 1, y.data(), 1,
+               _matrix, _stride);
+    return;
+  }
+#endif
+  const double* xd = x.data();
+  const double* yd = y.data();
+  run(executor, _rows, _cols, [=](int from, int to) {
+    for (int i = from; i < to; ++i) axpy(rowPtr(i), alpha * xd[i], yd, _cols);
+  });
+}
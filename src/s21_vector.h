@@ -0,0 +1,45 @@
+#ifndef __S21VECTOR_H__
+#define __S21VECTOR_H__
+
+#include <initializer_list>
+#include <vector>
+
+#include "s21_executor.h"
+#include "s21_matrix_oop.h"
+
+// dense vector in one contiguous buffer, the operand type of the level-2
+// kernels. Every kernel writes into an existing vector or matrix, so loops
+// that reuse their outputs do not allocate. With an executor the work is
+// split between its threads; small problems stay on the calling thread.
+class S21Vector {
+ private:
+  std::vector<double> _data;
+
+ public:
+  S21Vector() = default;
+  explicit S21Vector(int size);  // zero-filled
+  S21Vector(std::initializer_list<double> values);
+  // copies an n x 1 or 1 x n matrix
+  explicit S21Vector(const S21Matrix& m);
+
+  double& operator()(int i);  // checked
+  double operator()(int i) const;
+  double* data() { return _data.data(); }
+  const double* data() const { return _data.data(); }
+  int getSize() const;
+  void setSize(int size);  // keeps the leading elements, new ones are 0
+
+  S21Matrix ToMatrix() const;  // as an n x 1 column
+  bool EqVector(const S21Vector& o,
+                const S21Tolerance& tol = S21Tolerance()) const;
+
+  // *this = alpha * op(a) * x + beta * *this, BLAS dgemv semantics; with
+  // beta == 0 the old contents are ignored and *this is resized
+  void Gemv(S21Op op, double alpha, const S21Matrix& a, const S21Vector& x,
+            double beta = 0, S21Executor* executor = nullptr);
+  void Axpy(double alpha, const S21Vector& x);  // *this += alpha * x
+  double Dot(const S21Vector& o) const;
+  double Norm() const;  // Euclidean
+};
+
+#endif
@@ -0,0 +1,371 @@
+// performance regression harness: times every case at a fixed size, counts
+// heap allocations per call and compares both against a baseline file
+//
+//   ./perf_test baseline.txt [threshold]   fail on regressions
+//   ./perf_test --record baseline.txt      write a new baseline
+//
+// Each case is timed in batches, every batch right after a batch of a fixed
+// calibration kernel; the median ratio of the two is what is compared, so a
+// machine that slows down for a while slows both down alike. The baseline
+// records the compiler flags and the host it was measured on; on a
+// different build or host the timings are not checked and perf_test exits
+// with 3 once the allocation counts are compared.
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../s21_matrix_lazy.h"
+#include "../s21_matrix_oop.h"
+#include "../s21_vector.h"
+
+namespace {
+
+std::atomic<long long> allocations{0};
+
+void* allocate(size_t size) {
+  ++allocations;
+  if (void* p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void* allocate(size_t size, std::align_val_t align) {
+  ++allocations;
+  size_t a = static_cast<size_t>(align);
+  if (void* p = std::aligned_alloc(a, (size + a - 1) / a * a)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+}  // namespace
+
+// large buffers are mapped by s21_numa.cpp; the executable's mmap takes
+// precedence over the C library's, so those count as allocations too
+extern "C" void* mmap(void* addr, size_t len, int prot, int flags, int fd,
+                      off_t offset) noexcept {
+  ++allocations;
+  return reinterpret_cast<void*>(
+      syscall(SYS_mmap, addr, len, prot, flags, fd, offset));
+}
+
+// every form of global new goes through the counter
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+void* operator new(size_t size, std::align_val_t align) {
+  return allocate(size, align);
+}
+void* operator new[](size_t size, std::align_val_t align) {
+  return allocate(size, align);
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  try {
+    return allocate(size);
+  } catch (const std::bad_alloc&) {
+    return nullptr;
+  }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return operator new(size, std::nothrow);
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
+void operator delete[](void* p, size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+  std::free(p);
+}
+
+#ifndef S21_PERF_FLAGS
+#define S21_PERF_FLAGS "unknown"
+#endif
+
+namespace {
+
+// every batch runs for at least this long; the median of kBatches counts
+const double kBatchSeconds = 0.005;
+const int kBatches = 21;
+const int kRetries = 2;
+// a baseline is the median of this many measurements of each case, so it
+// sits in the middle of the spread rather than wherever one run fell
+const int kRecordPasses = 5;
+
+struct Result {
+  double ns = 0;         // time per call
+  double relative = 0;   // time per call over that of the calibration kernel
+  long long allocs = 0;  // heap allocations and mappings per call
+};
+
+// results are stored here so the calls are not optimised away
+volatile double sink;
+
+struct Case {
+  std::string name;
+  std::function<void()> run;
+};
+
+S21Matrix filled(int rows, int cols) {
+  S21Matrix m(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      m(i, j) = ((i * 7 + j * 13) % 17) - 8 + (i == j ? 4.0 * cols : 0);
+    }
+  }
+  return m;
+}
+
+// fixed work that does not go through the library, so changes to the
+// library do not move the yardstick: an element-wise sum over buffers the
+// size of the 256 x 256 inputs
+void calibration() {
+  static std::vector<double> x(1 << 16, 1.5), y(1 << 16, -0.5), z(1 << 16);
+  for (size_t i = 0; i < z.size(); ++i) z[i] = x[i] + y[i];
+  sink = z[z.size() / 2];
+}
+
+// time per call of one batch of at least kBatchSeconds
+double batch(const std::function<void()>& run) {
+  using Clock = std::chrono::steady_clock;
+  long long calls = 0;
+  Clock::time_point start = Clock::now();
+  double elapsed = 0;
+  do {
+    run();
+    ++calls;
+    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  } while (elapsed < kBatchSeconds);
+  return elapsed * 1e9 / calls;
+}
+
+double median(std::vector<double> values) {
+  std::nth_element(values.begin(), values.begin() + values.size() / 2,
+                   values.end());
+  return values[values.size() / 2];
+}
+
+Result measure(const Case& c) {
+  // warm-up, also sizes any lazily created state
+  for (int k = 0; k < 3; ++k) c.run();
+  batch(calibration);
+  Result res;
+  long long before = allocations;
+  c.run();
+  res.allocs = allocations - before;
+  std::vector<double> times, ratios;
+  for (int b = 0; b < kBatches; ++b) {
+    const double base = batch(calibration);
+    const double ns = batch(c.run);
+    times.push_back(ns);
+    ratios.push_back(ns / base);
+  }
+  res.ns = median(times);
+  res.relative = median(ratios);
+  return res;
+}
+
+std::vector<Case> cases() {
+  static S21Matrix a64 = filled(64, 64), b64 = filled(64, 64);
+  static S21Matrix a128 = filled(128, 128), b128 = filled(128, 128);
+  static S21Matrix a256 = filled(256, 256), b256 = filled(256, 256);
+  static S21Matrix c128(128, 128), rhs = filled(128, 4);
+  // the native determinant is a cofactor expansion, hence the small sizes
+  static S21Matrix a6 = filled(6, 6), a8 = filled(8, 8);
+  return {
+      {"sum_256", [] { sink = (a256 + b256)(0, 0); }},
+      {"sum_assign_256",
+       [] {
+         // a fresh copy each call, so every repetition sees the same data
+         static S21Matrix x;
+         x = a256;
+         x += b256;
+         sink = x(0, 0);
+       }},
+      {"mul_number_256",
+       [] {
+         // its own copy, the shared inputs stay as the other cases see them
+         static S21Matrix x = a256;
+         x *= 1.0;
+       }},
+      {"eq_256", [] { sink = a256 == b256; }},
+      {"transpose_256", [] { sink = a256.Transpose()(0, 0); }},
+      {"mul_64", [] { sink = (a64 * b64)(0, 0); }},
+      {"gemm_tn_128",
+       [] { c128.Gemm(S21Op::kTrans, S21Op::kNoTrans, 1, a128, b128); }},
+      {"determinant_8", [] { sink = a8.Determinant(); }},
+      {"inverse_6", [] { sink = a6.InverseMatrix()(0, 0); }},
+      {"complements_6", [] { sink = a6.CalcComplements()(0, 0); }},
+      {"solve_128", [] { sink = a128.Solve(rhs)(0, 0); }},
+      {"reduce_cols_256",
+       [] { sink = a256.Reduce(S21Reduction::kSum, S21Axis::kCols)(0, 0); }},
+      {"norm_256", [] { sink = a256.NormFrobenius(); }},
+      {"gemv_256",
+       [] {
+         static S21Vector x(256), y(256);
+         y.Gemv(S21Op::kNoTrans, 1, a256, x, 0.5);
+       }},
+      {"lazy_64",
+       [] {
+         S21Expr x(a64), y(b64);
+         sink = (x * y + x * y - y.Transpose()).Eval()(0, 0);
+       }},
+  };
+}
+
+// CPU model and count, recorded next to the build flags; not the host
+// name, which changes with every container
+std::string host() {
+  std::string cpu = "unknown";
+  std::ifstream info("/proc/cpuinfo");
+  for (std::string line; std::getline(info, line);) {
+    if (line.compare(0, 10, "model name") == 0) {
+      cpu = line.substr(line.find(':') + 2);
+      break;
+    }
+  }
+  return cpu + " x " + std::to_string(std::thread::hardware_concurrency());
+}
+
+bool record(const std::string& path) {
+  std::ofstream out(path);
+  if (!out) {
+    std::cerr << "cannot write " << path << "\n";
+    return false;
+  }
+  out << "# build " << S21_PERF_FLAGS << "\n";
+  out << "# host " << host() << "\n";
+  out << "# name ns_per_call relative_to_calibration allocations_per_call\n";
+  for (const Case& c : cases()) {
+    std::vector<double> times, ratios;
+    Result r;
+    for (int pass = 0; pass < kRecordPasses; ++pass) {
+      r = measure(c);
+      times.push_back(r.ns);
+      ratios.push_back(r.relative);
+    }
+    r.ns = median(times);
+    r.relative = median(ratios);
+    out << c.name << " " << r.ns << " " << r.relative << " " << r.allocs
+        << "\n";
+    std::cout << c.name << ": " << r.ns << " ns (" << r.relative
+              << " x calibration), " << r.allocs << " allocations\n";
+  }
+  return true;
+}
+
+// the result of check
+enum class Verdict { kPassed, kFailed, kNotChecked };
+
+Verdict check(const std::string& path, double threshold) {
+  std::ifstream in(path);
+  if (!in) {
+    std::cerr << "no baseline at " << path << ", run make perf_baseline\n";
+    return Verdict::kFailed;
+  }
+  std::map<std::string, Result> baseline;
+  std::string build, machine;
+  for (std::string line; std::getline(in, line);) {
+    if (line.compare(0, 8, "# build ") == 0) {
+      build = line.substr(8);
+    } else if (line.compare(0, 7, "# host ") == 0) {
+      machine = line.substr(7);
+    }
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::string name;
+    Result r;
+    if (fields >> name >> r.ns >> r.relative >> r.allocs) {
+      baseline[name] = r;
+    }
+  }
+  // timings only mean something against the same build on the same host
+  const bool timed = build == S21_PERF_FLAGS && machine == host();
+  if (!timed) {
+    std::cout << "[NOT CHECKED] baseline is from another build or host, "
+                 "timings are NOT checked; record one with make "
+                 "perf_baseline\n"
+              << "             baseline: " << build << " on " << machine
+              << "\n             current:  " << S21_PERF_FLAGS << " on "
+              << host() << "\n";
+  }
+  bool ok = true;
+  for (const Case& c : cases()) {
+    auto it = baseline.find(c.name);
+    if (it == baseline.end()) {
+      std::cout << "[ SKIPPED  ] " << c.name << ": not in baseline\n";
+      continue;
+    }
+    const Result& base = it->second;
+    const double limit = base.relative * (1 + threshold);
+    Result r = measure(c);
+    // a slow case is measured again before it counts
+    for (int retry = 0; timed && retry < kRetries && r.relative > limit;
+         ++retry) {
+      Result again = measure(c);
+      if (again.relative < r.relative) {
+        r = again;
+      }
+    }
+    // allocation counts are exact, only time gets the tolerance
+    bool pass = (!timed || r.relative <= limit) && r.allocs <= base.allocs;
+    ok &= pass;
+    std::cout << (pass ? (timed ? "[       OK ] " : "[NOT CHECKED] ")
+                       : "[  FAILED  ] ")
+              << c.name << ": " << r.ns << " ns, " << r.relative
+              << " x calibration (baseline " << base.relative << "), "
+              << r.allocs << " allocations (baseline " << base.allocs
+              << ")\n";
+  }
+  if (!ok) {
+    return Verdict::kFailed;
+  }
+  return timed ? Verdict::kPassed : Verdict::kNotChecked;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::vector<std::string> args(argv + 1, argv + argc);
+  if (args.size() == 2 && args[0] == "--record") {
+    return record(args[1]) ? 0 : 1;
+  }
+  if (args.size() == 1 || args.size() == 2) {
+    double threshold = args.size() == 2 ? std::atof(args[1].c_str()) : 0.3;
+    switch (check(args[0], threshold)) {
+      case Verdict::kPassed:
+        return 0;
+      case Verdict::kNotChecked:
+        return 3;
+      default:
+        return 1;
+    }
+  }
+  std::cerr << "usage: " << argv[0] << " [--record] baseline [threshold]\n";
+  return 2;
+}
@@ -1,8 +1,21 @@
 #include <gtest/gtest.h>
 
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
 #include <iostream>
 
+#include "../s21_matrix_async.h"
+#include "../s21_matrix_cache.h"
+#include "../s21_matrix_lazy.h"
 #include "../s21_matrix_oop.h"
+#include "../s21_matrix_structured.h"
+#include "../s21_matrix_tiled.h"
+#include "../s21_vector.h"
+#if __has_include(<Eigen/Core>)
+#include "../s21_matrix_eigen.h"
+#endif
 
 /*
 logic_error	- сообщения об ошибках во внутренней логике программы, таких как
@@ -76,6 +89,35 @@ TEST(test_class, square_brackets_operator) {
   EXPECT_THROW(mat[10], std::out_of_range);
 }
 
+TEST(test_class, const_brackets_operator) {
+  S21Matrix mat(2, 3);
+  mat(1, 2) = 4.5;
+  const S21Matrix& view = mat;
+  EXPECT_EQ(view(1, 2), 4.5);
+  EXPECT_THROW(view(2, 0), std::out_of_range);
+  EXPECT_THROW(view(0, 3), std::out_of_range);
+}
+
+TEST(test_class, raw_access) {
+  S21Matrix mat(3, 4);
+  mat.at_unchecked(2, 1) = 7;
+  mat.at(0, 3) = -1;
+  const S21Matrix& view = mat;
+
+  ASSERT_EQ(view.stride(), 4);
+  EXPECT_EQ(view.data()[2 * view.stride() + 1], 7);
+  EXPECT_EQ(view.at_unchecked(0, 3), -1);
+  EXPECT_EQ(view.at(2, 1), 7);
+  mat.data()[5] = 3;
+  EXPECT_EQ(mat(1, 1), 3);
+#ifdef __cpp_lib_span
+  double sum = 0;
+  for (double v : view.row(2)) sum += v;
+  EXPECT_EQ(sum, 7);
+  EXPECT_EQ(mat.row(1).size(), 4u);
+#endif
+}
+
 TEST(test_mutators, valid_setRow) {
   S21Matrix mat(1, 1);
   EXPECT_THROW(mat.setRow(-3), std::length_error);
@@ -187,6 +229,68 @@ TEST(test_methods, eq_matrix3) {
   ASSERT_FALSE(mat == n);
 }
 
+TEST(test_methods, compare_relative) {
+  S21Matrix mat(2, 2);
+  S21Matrix n(2, 2);
+  mat(1, 1) = 1e12;
+  n(1, 1) = 1e12 + 1;
+
+  ASSERT_FALSE(mat.EqMatrix(n));
+  S21Tolerance tol;
+  tol.rel = 1e-9;
+  ASSERT_TRUE(mat.EqMatrix(n, tol));
+}
+
+TEST(test_methods, compare_ulp) {
+  S21Matrix mat(1, 2);
+  S21Matrix n(1, 2);
+  mat(0, 0) = 1e-20;
+  n(0, 0) = std::nextafter(1e-20, 1.0);
+  mat(0, 1) = 1.0;
+  n(0, 1) = std::nextafter(std::nextafter(1.0, 2.0), 2.0);
+
+  S21Tolerance tol;
+  tol.abs = 0;
+  ASSERT_FALSE(mat.EqMatrix(n, tol));
+  tol.ulp = 2;
+  ASSERT_TRUE(mat.EqMatrix(n, tol));
+  tol.ulp = 1;
+  S21CompareResult res = mat.Compare(n, tol);
+  ASSERT_FALSE(res.equal);
+  EXPECT_EQ(res.row, 0);
+  EXPECT_EQ(res.col, 1);
+}
+
+TEST(test_methods, compare_first_and_max) {
+  S21Matrix mat(40, 30);
+  S21Matrix n(40, 30);
+  n(3, 7) = 1;
+  n(35, 2) = 5;
+
+  S21CompareResult first = mat.Compare(n);
+  ASSERT_FALSE(first.equal);
+  EXPECT_EQ(first.row, 3);
+  EXPECT_EQ(first.col, 7);
+  EXPECT_EQ(first.diff, 1);
+
+  S21CompareResult max = mat.Compare(n, S21Tolerance(), S21CompareMode::kMax);
+  ASSERT_FALSE(max.equal);
+  EXPECT_EQ(max.row, 35);
+  EXPECT_EQ(max.col, 2);
+  EXPECT_EQ(max.diff, 5);
+}
+
+TEST(test_methods, compare_nan) {
+  S21Matrix mat(1, 1);
+  S21Matrix n(1, 1);
+  mat(0, 0) = NAN;
+  n(0, 0) = NAN;
+  S21Tolerance tol;
+  tol.ulp = 4;
+  ASSERT_FALSE(mat.EqMatrix(n, tol));
+  ASSERT_TRUE(mat.Compare(mat, tol, S21CompareMode::kMax).diff == INFINITY);
+}
+
 TEST(test_methods, sum_matrix) {
   S21Matrix mat(2, 2);
   S21Matrix n(2, 2);
@@ -421,6 +525,48 @@ TEST(test_methods, mul_operator_num) {
   ASSERT_TRUE(mat == res);
 }
 
+TEST(test_methods, gemm_transposed_operands) {
+  S21Matrix a(3, 2), b(3, 4), c(2, 4);
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 2; ++j) a(i, j) = i - 2 * j + 1;
+    for (int j = 0; j < 4; ++j) b(i, j) = i * j - 1;
+  }
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 4; ++j) c(i, j) = i + j;
+  }
+  S21Matrix expected = a.Transpose() * b * 2.0 + c * 0.5;
+  S21Matrix res(c);
+  res.Gemm(S21Op::kTrans, S21Op::kNoTrans, 2, a, b, 0.5);
+  ASSERT_TRUE(res == expected);
+
+  S21Matrix bt = b.Transpose(), at = a.Transpose();
+  S21Matrix nt, tt, nn;
+  nt.Gemm(S21Op::kNoTrans, S21Op::kTrans, 1, at, bt);
+  tt.Gemm(S21Op::kTrans, S21Op::kTrans, 1, a, bt);
+  nn.Gemm(S21Op::kNoTrans, S21Op::kNoTrans, 1, at, b);
+  S21Matrix product = a.Transpose() * b;
+  ASSERT_TRUE(nt == product);
+  ASSERT_TRUE(tt == product);
+  ASSERT_TRUE(nn == product);
+}
+
+TEST(test_methods, gemm_aliasing_and_sizes) {
+  S21Matrix a(2, 2);
+  a(0, 0) = 1;
+  a(0, 1) = 2;
+  a(1, 0) = 3;
+  a(1, 1) = 4;
+  S21Matrix expected = a * a + a;
+  a.Gemm(S21Op::kNoTrans, S21Op::kNoTrans, 1, a, a, 1);
+  ASSERT_TRUE(a == expected);
+
+  S21Matrix c(3, 3);
+  EXPECT_THROW(c.Gemm(S21Op::kNoTrans, S21Op::kNoTrans, 1, a, a, 1),
+               std::invalid_argument);
+  EXPECT_THROW(c.Gemm(S21Op::kTrans, S21Op::kNoTrans, 1, S21Matrix(2, 3), c),
+               std::invalid_argument);
+}
+
 TEST(test_methods, transpose) {
   size_t rows = 2;
   size_t cols = 3;
@@ -735,6 +881,1091 @@ TEST(test_methods, inverese_3x3_3) {
   ASSERT_TRUE(example.InverseMatrix() == result);
 }
 
+TEST(test_reduce, axes) {
+  S21Matrix mat(3, 5);
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 5; ++j) mat(i, j) = (i + 1) * (j - 2);
+  }
+  S21Matrix rows = mat.Reduce(S21Reduction::kSum, S21Axis::kRows);
+  S21Matrix cols = mat.Reduce(S21Reduction::kMax, S21Axis::kCols);
+  S21Matrix mins = mat.Reduce(S21Reduction::kMin, S21Axis::kRows);
+  S21Matrix norms = mat.Reduce(S21Reduction::kNorm, S21Axis::kCols);
+
+  ASSERT_EQ(rows.getRow(), 3);
+  ASSERT_EQ(rows.getCol(), 1);
+  ASSERT_EQ(cols.getRow(), 1);
+  ASSERT_EQ(cols.getCol(), 5);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(rows(i, 0), 0);
+    EXPECT_EQ(mins(i, 0), -2 * (i + 1));
+  }
+  EXPECT_EQ(cols(0, 0), -2);
+  EXPECT_EQ(cols(0, 4), 6);
+  EXPECT_DOUBLE_EQ(norms(0, 1), std::sqrt(14.0));
+  EXPECT_EQ(mat.Sum(), 0);
+  EXPECT_EQ(mat.MaxAbs(), 6);
+  EXPECT_DOUBLE_EQ(mat.NormFrobenius(), std::sqrt(140.0));
+}
+
+TEST(test_reduce, nan_propagates) {
+  S21Executor executor(3);
+  S21Matrix mat(300, 300);
+  for (int i = 0; i < 300; ++i) {
+    for (int j = 0; j < 300; ++j) mat(i, j) = i - j;
+  }
+  // first, middle and last of a row, so every lane and the tail see one
+  mat(0, 0) = NAN;
+  mat(1, 150) = NAN;
+  mat(2, 299) = NAN;
+  S21Reduction ops[5] = {S21Reduction::kSum, S21Reduction::kNorm,
+                         S21Reduction::kMaxAbs, S21Reduction::kMin,
+                         S21Reduction::kMax};
+  for (S21Reduction op : ops) {
+    for (S21Executor* ex : {static_cast<S21Executor*>(nullptr), &executor}) {
+      EXPECT_TRUE(std::isnan(mat.Reduce(op, S21Axis::kAll, ex)(0, 0)));
+      S21Matrix rows = mat.Reduce(op, S21Axis::kRows, ex);
+      S21Matrix cols = mat.Reduce(op, S21Axis::kCols, ex);
+      for (int i = 0; i < 3; ++i) EXPECT_TRUE(std::isnan(rows(i, 0)));
+      EXPECT_FALSE(std::isnan(rows(3, 0)));
+      EXPECT_TRUE(std::isnan(cols(0, 150)));
+      EXPECT_FALSE(std::isnan(cols(0, 1)));
+    }
+  }
+  EXPECT_TRUE(std::isnan(mat.MaxAbs()));
+}
+
+TEST(test_reduce, parallel_matches_sequential) {
+  S21Executor executor(3);
+  S21Matrix mat(257, 300);
+  for (int i = 0; i < 257; ++i) {
+    for (int j = 0; j < 300; ++j) mat(i, j) = std::cos(i * 300.0 + j);
+  }
+  S21Axis axes[3] = {S21Axis::kRows, S21Axis::kCols, S21Axis::kAll};
+  S21Tolerance tol;
+  tol.rel = 1e-12;
+  tol.abs = 1e-12;
+  for (S21Axis axis : axes) {
+    S21Matrix seq = mat.Reduce(S21Reduction::kSum, axis);
+    S21Matrix par = mat.Reduce(S21Reduction::kSum, axis, &executor);
+    EXPECT_TRUE(seq.EqMatrix(par, tol));
+    seq = mat.Reduce(S21Reduction::kMaxAbs, axis);
+    par = mat.Reduce(S21Reduction::kMaxAbs, axis, &executor);
+    EXPECT_TRUE(seq == par);
+  }
+}
+
+// many more rows than workers, so every worker writes into the result
+TEST(test_reduce, parallel_rows_tall) {
+  S21Executor executor(8);
+  S21Matrix mat(4000, 20);
+  for (int i = 0; i < 4000; ++i) {
+    for (int j = 0; j < 20; ++j) mat(i, j) = i - j;
+  }
+  S21Matrix sums = mat.Reduce(S21Reduction::kSum, S21Axis::kRows, &executor);
+  for (int i = 0; i < 4000; i += 333) {
+    ASSERT_EQ(sums(i, 0), 20.0 * i - 190);
+  }
+  ASSERT_TRUE(sums == mat.Reduce(S21Reduction::kSum, S21Axis::kRows));
+}
+
+TEST(test_reduce, maps) {
+  S21Matrix a(2, 3), b(2, 3);
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      a(i, j) = i + j;
+      b(i, j) = j - i;
+    }
+  }
+  S21Matrix h(a);
+  h.HadamardMatrix(b);
+  EXPECT_EQ(h(1, 2), 3);
+  EXPECT_EQ(h(1, 0), -1);
+
+  a.Apply([](double x) { return x * x; }).Apply(b, [](double x, double y) {
+    return x + 2 * y;
+  });
+  EXPECT_EQ(a(1, 2), 11);
+  EXPECT_EQ(a(0, 0), 0);
+  EXPECT_THROW(a.HadamardMatrix(S21Matrix(3, 2)), std::invalid_argument);
+}
+
+S21Matrix parity_example(int n) {
+  S21Matrix mat(n, n);
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) mat(i, j) = std::sin(i * n + j + 1.0) + (i == j);
+  }
+  return mat;
+}
+
+TEST(test_solve, solve) {
+  S21Matrix a = parity_example(5);
+  S21Matrix b(5, 2);
+  for (int i = 0; i < 5; ++i) {
+    b(i, 0) = i;
+    b(i, 1) = 1 - i;
+  }
+  S21Matrix x = a.Solve(b);
+  ASSERT_TRUE(a * x == b);
+  EXPECT_THROW(a.Solve(S21Matrix(4, 1)), std::invalid_argument);
+  EXPECT_THROW(S21Matrix(3, 3).Solve(S21Matrix(3, 1)), std::logic_error);
+}
+
+TEST(test_solve, solve_mixed) {
+  S21Matrix a = parity_example(8);
+  S21Matrix b(8, 2);
+  for (int i = 0; i < 8; ++i) {
+    b(i, 0) = 1.0 / (i + 1);
+    b(i, 1) = i * 1e3;
+  }
+  S21RefineInfo info;
+  S21Matrix x = a.SolveMixed(b, &info);
+  S21Tolerance tol;
+  tol.rel = 1e-12;
+  EXPECT_FALSE(info.fallback);
+  EXPECT_GT(info.iterations, 0);
+  EXPECT_TRUE(x.EqMatrix(a.Solve(b), tol));
+}
+
+TEST(test_solve, solve_mixed_fallback) {
+  // entries beyond float range cannot be factorised in single precision
+  S21Matrix a(2, 2);
+  a(0, 0) = 1e300;
+  a(1, 1) = 2;
+  S21Matrix b(2, 1);
+  b(0, 0) = 1e300;
+  b(1, 0) = 4;
+  S21RefineInfo info;
+  S21Matrix x = a.SolveMixed(b, &info);
+  EXPECT_TRUE(info.fallback);
+  EXPECT_DOUBLE_EQ(x(0, 0), 1);
+  EXPECT_DOUBLE_EQ(x(1, 0), 2);
+
+  // a nearly singular system stalls and falls back as well
+  S21Matrix c(2, 2);
+  c(0, 0) = 1;
+  c(0, 1) = 1;
+  c(1, 0) = 1;
+  c(1, 1) = 1 + 1e-9;
+  b(0, 0) = 2;
+  b(1, 0) = 2 + 1e-9;
+  c.SolveMixed(b, &info);
+  EXPECT_TRUE(info.fallback);
+}
+
+#ifdef S21_USE_BLAS
+// every routed operation must agree between the vendor and in-house kernels
+TEST(test_solve, blas_parity) {
+  S21Matrix a = parity_example(6), b = parity_example(6) * 0.5;
+  S21Matrix rhs(6, 3);
+  for (int i = 0; i < 6; ++i) {
+    for (int j = 0; j < 3; ++j) rhs(i, j) = i - j;
+  }
+  S21Matrix product[2], tn[2], inverse[2], solution[2];
+  double det[2];
+  S21Backend backends[2] = {S21Backend::kNative, S21Backend::kBlas};
+  for (int k = 0; k < 2; ++k) {
+    S21Matrix::setBackend(backends[k]);
+    product[k] = a * b;
+    tn[k] = S21Matrix(b);
+    tn[k].Gemm(S21Op::kTrans, S21Op::kTrans, 1.5, a, b, -2);
+    det[k] = a.Determinant();
+    inverse[k] = a.InverseMatrix();
+    solution[k] = a.Solve(rhs);
+  }
+  S21Tolerance tol;
+  tol.abs = 0;  // purely relative, small elements get no absolute slack
+  tol.rel = 1e-12;
+  EXPECT_TRUE(product[0].EqMatrix(product[1], tol));
+  EXPECT_TRUE(tn[0].EqMatrix(tn[1], tol));
+  EXPECT_NEAR(det[0], det[1], 1e-10 * std::fabs(det[0]));
+  EXPECT_TRUE(inverse[0].EqMatrix(inverse[1], tol));
+  EXPECT_TRUE(solution[0].EqMatrix(solution[1], tol));
+  EXPECT_THROW(S21Matrix(2, 2).InverseMatrix(), std::logic_error);
+  EXPECT_EQ(S21Matrix(2, 2).Determinant(), 0);
+}
+#else
+TEST(test_solve, native_backend_only) {
+  EXPECT_EQ(S21Matrix::getBackend(), S21Backend::kNative);
+  EXPECT_THROW(S21Matrix::setBackend(S21Backend::kBlas), std::logic_error);
+}
+#endif
+
+S21Matrix symmetric_example() {
+  S21Matrix mat(4, 4);
+  double values[4][4] = {
+      {4, 1, -2, 2}, {1, 2, 0, 1}, {-2, 0, 3, -2}, {2, 1, -2, -1}};
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 4; ++j) mat(i, j) = values[i][j];
+  }
+  return mat;
+}
+
+TEST(test_decomp, eigen_symmetric) {
+  S21Matrix mat = symmetric_example();
+  S21EigenResult eig = mat.EigenSymmetric();
+
+  S21Matrix diag(4, 4);
+  for (int i = 0; i < 4; ++i) diag(i, i) = eig.values(i, 0);
+  for (int i = 1; i < 4; ++i) ASSERT_GE(eig.values(i - 1, 0), eig.values(i, 0));
+  ASSERT_TRUE(mat * eig.vectors == eig.vectors * diag);
+  S21Matrix identity(4, 4);
+  for (int i = 0; i < 4; ++i) identity(i, i) = 1;
+  ASSERT_TRUE(eig.vectors.Transpose() * eig.vectors == identity);
+}
+
+TEST(test_decomp, eigen_top_k) {
+  S21Matrix mat = symmetric_example();
+  S21EigenResult full = mat.EigenSymmetric(false);
+  S21EigenResult top = mat.EigenSymmetricTopK(2);
+
+  EXPECT_EQ(full.vectors.getRow(), 0);
+  ASSERT_EQ(top.vectors.getCol(), 2);
+  for (int j = 0; j < 2; ++j) {
+    EXPECT_NEAR(top.values(j, 0), full.values(j, 0), 1e-10);
+    S21Matrix v(4, 1);
+    for (int i = 0; i < 4; ++i) v(i, 0) = top.vectors(i, j);
+    ASSERT_TRUE(mat * v == v * top.values(j, 0));
+  }
+  EXPECT_THROW(mat.EigenSymmetricTopK(5), std::invalid_argument);
+  EXPECT_THROW(S21Matrix(2, 3).EigenSymmetric(), std::invalid_argument);
+}
+
+TEST(test_decomp, svd) {
+  S21Matrix mat(3, 5);
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 5; ++j) mat(i, j) = (i + 1) * (j - 2) + (i == j);
+  }
+  S21SvdResult svd = mat.Svd();
+  ASSERT_EQ(svd.u.getRow(), 3);
+  ASSERT_EQ(svd.v.getRow(), 5);
+  ASSERT_EQ(svd.s.getRow(), 3);
+
+  S21Matrix diag(3, 3);
+  for (int i = 0; i < 3; ++i) diag(i, i) = svd.s(i, 0);
+  ASSERT_TRUE(svd.u * diag * svd.v.Transpose() == mat);
+
+  S21SvdResult top = mat.SvdTopK(2);
+  for (int j = 0; j < 2; ++j) {
+    EXPECT_NEAR(top.s(j, 0), svd.s(j, 0), 1e-8);
+  }
+  S21Matrix top_diag(2, 2);
+  for (int i = 0; i < 2; ++i) top_diag(i, i) = top.s(i, 0);
+  S21Matrix approx = top.u * top_diag * top.v.Transpose();
+  S21Matrix residual = mat - approx;
+  double err = 0;
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 5; ++j) err += residual(i, j) * residual(i, j);
+  }
+  EXPECT_NEAR(std::sqrt(err), svd.s(2, 0), 1e-8);
+}
+
+TEST(test_decomp, svd_rank_deficient) {
+  // rank 2 with an exactly zero column, so two singular values vanish
+  S21Matrix mat(5, 4);
+  for (int i = 0; i < 5; ++i) {
+    mat(i, 0) = i + 1;
+    mat(i, 1) = 2 * (i + 1);
+    mat(i, 2) = (i % 2) - 3;
+  }
+  S21Matrix eye(4, 4);
+  for (int i = 0; i < 4; ++i) eye(i, i) = 1;
+
+  S21SvdResult svd = mat.Svd();
+  EXPECT_EQ(svd.s(3, 0), 0);
+  ASSERT_TRUE(svd.u.Transpose() * svd.u == eye);
+  ASSERT_TRUE(svd.v.Transpose() * svd.v == eye);
+  S21Matrix diag(4, 4);
+  for (int i = 0; i < 4; ++i) diag(i, i) = svd.s(i, 0);
+  ASSERT_TRUE(svd.u * diag * svd.v.Transpose() == mat);
+
+  S21SvdResult top = mat.SvdTopK(4);
+  ASSERT_TRUE(top.u.Transpose() * top.u == eye);
+  for (int j = 0; j < 2; ++j) EXPECT_NEAR(top.s(j, 0), svd.s(j, 0), 1e-8);
+  // the wide orientation completes v instead
+  S21Matrix wide = mat.Transpose().SvdTopK(3).v;
+  S21Matrix eye3(3, 3);
+  for (int i = 0; i < 3; ++i) eye3(i, i) = 1;
+  ASSERT_TRUE(wide.Transpose() * wide == eye3);
+}
+
+TEST(test_async, chained_operations) {
+  S21Matrix a(3, 3);
+  S21Matrix b(3, 3);
+  for (int i = 0; i < 3; ++i) {
+    a(i, i) = 2;
+    b(i, (i + 1) % 3) = 1;
+  }
+  S21AsyncMatrix x = S21AsyncMatrix::Borrow(a);
+  S21AsyncMatrix y(b);
+  S21AsyncMatrix prod = x.Mul(y);
+  S21AsyncMatrix res = prod.Sum(prod.Transpose()).MulNumber(0.5).Inverse();
+
+  S21Matrix expected = ((a * b) + (a * b).Transpose()) * 0.5;
+  ASSERT_TRUE(expected.InverseMatrix() == res.get());
+  ASSERT_TRUE(res.isReady());
+  S21Matrix direct = a * b;
+  ASSERT_TRUE(direct == prod.get());
+}
+
+TEST(test_async, custom_operation) {
+  S21Executor executor(2);
+  S21AsyncMatrix a(S21Matrix(2, 2));
+  S21AsyncMatrix res = S21AsyncMatrix::Then(
+      {a, a},
+      [](const S21AsyncMatrix::Operands& m) {
+        S21Matrix sum(*m[0]);
+        sum.SumMatrix(*m[1]);
+        sum(1, 1) = 5;
+        return sum;
+      },
+      executor);
+  res.done().wait();
+  EXPECT_EQ(res.get()[1][1], 5);
+}
+
+TEST(test_async, error_propagation) {
+  S21AsyncMatrix a(S21Matrix(2, 3));
+  S21AsyncMatrix b(S21Matrix(2, 2));
+  S21AsyncMatrix bad = a.Mul(b);
+  S21AsyncMatrix after = bad.Transpose();
+  EXPECT_THROW(after.get(), std::invalid_argument);
+  EXPECT_THROW(bad.get(), std::invalid_argument);
+  EXPECT_THROW(b.Inverse().get(), std::logic_error);
+}
+
+TEST(test_async, parallel_for_exception) {
+  S21Executor pool(3);
+  std::atomic<int> ran{0};
+  // every chunk throws, on the caller and on the workers alike
+  EXPECT_THROW(pool.ParallelFor(0, 1000, 1,
+                                [&ran](int, int) {
+                                  ++ran;
+                                  throw std::runtime_error("chunk");
+                                }),
+               std::runtime_error);
+  ASSERT_LE(ran, 3);  // one chunk per participant, the rest were dropped
+  EXPECT_THROW(pool.ParallelFor(0, 1000, 1,
+                                [](int from, int to) {
+                                  if (from <= 500 && 500 < to) {
+                                    throw std::out_of_range("chunk");
+                                  }
+                                }),
+               std::out_of_range);
+  std::atomic<int> covered{0};
+  pool.ParallelFor(0, 1000, 1,
+                   [&covered](int from, int to) { covered += to - from; });
+  ASSERT_EQ(covered, 1000);
+}
+
+S21Matrix filled(int rows, int cols, double seed) {
+  S21Matrix mat(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) mat(i, j) = seed * (i + 1) - j * 0.5;
+  }
+  return mat;
+}
+
+TEST(test_lazy, shared_product) {
+  S21Matrix a = filled(3, 4, 1.5), b = filled(4, 3, -0.5);
+  S21Expr x(a), y(b);
+  S21Matrix res = ((x * y).Transpose() + (x * y) * 2.0).Eval();
+
+  S21Matrix eager = (a * b).Transpose() + (a * b) * 2.0;
+  ASSERT_TRUE(res == eager);
+}
+
+TEST(test_lazy, transposed_operands) {
+  S21Matrix a = filled(4, 3, 2), b = filled(4, 5, 0.25), c = filled(5, 3, 1);
+  S21Expr x(a), y(b), z(c);
+  S21Matrix tn = (x.Transpose() * y).Eval();
+  S21Matrix nt = (y.Transpose() * x * z.Transpose()).Eval();
+  S21Matrix tt = (2.0 * (z.Transpose() * y.Transpose()) - x.Transpose()).Eval();
+
+  ASSERT_TRUE(tn == a.Transpose() * b);
+  ASSERT_TRUE(nt == b.Transpose() * a * c.Transpose());
+  S21Matrix product = c.Transpose() * b.Transpose();
+  ASSERT_TRUE(tt == product * 2.0 - a.Transpose());
+}
+
+TEST(test_lazy, fused_accumulation) {
+  S21Matrix a = filled(3, 3, 1), b = filled(3, 3, -2), c = filled(3, 3, 3);
+  S21Expr x(a), y(b), z(c);
+  S21Matrix sum = (z - (x * y * 3.0).Transpose()).Eval();
+  S21Matrix leaf = S21Expr(c).Eval();
+
+  S21Matrix eager = c - (a * b * 3.0).Transpose();
+  ASSERT_TRUE(sum == eager);
+  ASSERT_TRUE(leaf == c);
+  EXPECT_THROW(x * S21Expr(S21Matrix(2, 2)), std::invalid_argument);
+  EXPECT_THROW(x + S21Expr(S21Matrix(3, 2)), std::invalid_argument);
+}
+
+TEST(test_interop, wrap_strided) {
+  std::vector<double> buffer(3 * 5, -1);
+  S21Matrix view = S21Matrix::Wrap(buffer.data(), 3, 4, 5);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 4; j++) view(i, j) = i * 4 + j;
+  }
+  ASSERT_FALSE(view.ownsData());
+  ASSERT_EQ(view.stride(), 5);
+  ASSERT_EQ(buffer[5], 4);
+  ASSERT_EQ(buffer[4], -1);
+
+  S21Matrix copy(view);
+  ASSERT_TRUE(copy.ownsData());
+  ASSERT_EQ(copy.stride(), 4);
+  ASSERT_TRUE(copy == view);
+  view += copy;
+  ASSERT_EQ(buffer[11], 18);
+  ASSERT_DOUBLE_EQ((view * copy.Transpose())(1, 1), 2 * (16 + 25 + 36 + 49));
+
+  view.setRow(2);
+  ASSERT_TRUE(view.ownsData());
+  ASSERT_EQ(buffer[0], 0);
+  EXPECT_THROW(S21Matrix::Wrap(buffer.data(), 3, 4, 3), std::invalid_argument);
+  EXPECT_THROW(S21Matrix::Wrap(nullptr, 3, 4), std::invalid_argument);
+}
+
+TEST(test_interop, dltensor) {
+  double buffer[2][4] = {{1, 2, 3, 0}, {4, 5, 6, 0}};
+  S21DLTensor tensor;
+  tensor.data = buffer;
+  tensor.shape[0] = 2;
+  tensor.shape[1] = 3;
+  tensor.strides[0] = 4;
+  S21Matrix view = S21Matrix::FromDLTensor(tensor);
+  ASSERT_EQ(view(1, 2), 6);
+  view(0, 0) = 7;
+  ASSERT_EQ(buffer[0][0], 7);
+
+  S21DLTensor back = view.ToDLTensor();
+  ASSERT_EQ(back.data, buffer);
+  ASSERT_EQ(back.strides[0], 4);
+  ASSERT_EQ(back.shape[1], 3);
+
+  tensor.dtype_bits = 32;
+  EXPECT_THROW(S21Matrix::FromDLTensor(tensor), std::invalid_argument);
+  tensor.dtype_bits = 64;
+  tensor.strides[1] = 2;
+  EXPECT_THROW(S21Matrix::FromDLTensor(tensor), std::invalid_argument);
+}
+
+#if __has_include(<Eigen/Core>)
+TEST(test_interop, eigen) {
+  S21EigenMatrix e(3, 4);
+  e << 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12;
+  S21Matrix block = S21FromEigen(e.block(1, 1, 2, 2));
+  ASSERT_EQ(block.stride(), 4);
+  ASSERT_EQ(block(1, 1), 11);
+  block(0, 0) = 0;
+  ASSERT_EQ(e(1, 1), 0);
+
+  S21Matrix m = filled(2, 3, 1);
+  S21ToEigen(m) *= 2;
+  ASSERT_EQ(m(1, 2), 2);
+  const S21Matrix& cm = m;
+  ASSERT_EQ(S21ToEigen(cm).sum(), m.Sum());
+}
+#endif
+
+TEST(test_numa, placements) {
+  // 512 x 512 doubles are past the mapped-buffer threshold
+  S21Matrix ref = filled(512, 512, 0.5);
+  const S21Placement placements[] = {
+      S21Placement::kDefault, S21Placement::kFirstTouch,
+      S21Placement::kInterleave, S21Placement::kBlocked};
+  for (S21Placement placement : placements) {
+    S21Matrix::setPlacement(placement);
+    ASSERT_EQ(S21Matrix::getPlacement(), placement);
+    S21Matrix m(512, 512);
+    ASSERT_EQ(m.Sum(), 0);
+    m += ref;
+    S21Matrix copy = m;
+    ASSERT_TRUE(copy == ref);
+    copy.setCol(3);
+    ASSERT_EQ(copy(511, 2), ref(511, 2));
+  }
+  S21Matrix::setPlacement(S21Placement::kDefault);
+}
+
+// get_mempolicy flags from <numaif.h>
+const int kMpolFNode = 1;
+const int kMpolFAddr = 2;
+
+TEST(test_numa, first_touch_locality) {
+  S21Executor& pool = S21Executor::Pinned();
+  const int workers = pool.getThreads();
+  std::vector<int> worker_node(workers, -1);
+  pool.ForEachWorker([&worker_node](int worker) {
+    unsigned cpu, node;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+      worker_node[worker] = static_cast<int>(node);
+    }
+  });
+  S21Matrix::setPlacement(S21Placement::kFirstTouch);
+  S21Matrix m(1024, 512 * workers);
+  S21Matrix::setPlacement(S21Placement::kDefault);
+  // the first page of row block k must sit on the node of worker k
+  const double* base = static_cast<const S21Matrix&>(m).data();
+  const long page = sysconf(_SC_PAGESIZE);
+  const long bytes = static_cast<long>(sizeof(double)) * m.getRow() * m.stride();
+  const long pages = (bytes + page - 1) / page;
+  for (int k = 0; k < workers; ++k) {
+    const char* addr =
+        reinterpret_cast<const char*>(base) + pages * k / workers * page;
+    int node = -1;
+    if (syscall(SYS_get_mempolicy, &node, nullptr, 0, addr,
+                kMpolFNode | kMpolFAddr) != 0) {
+      GTEST_SKIP() << "get_mempolicy is not available";
+    }
+    ASSERT_EQ(node, worker_node[k]) << "block " << k;
+  }
+  S21Matrix doubled = m;
+  pool.ParallelFor(0, m.getRow(), 1, [&](int from, int to) {
+    for (int i = from; i < to; ++i) doubled[i][0] = 2 * i;
+  });
+  ASSERT_EQ(doubled(1023, 0), 2046);
+}
+
+TEST(test_numa, pinned_executor) {
+  S21Executor pool(2, true);
+  std::atomic<int> covered{0};
+  pool.ParallelFor(0, 64, 1,
+                   [&covered](int from, int to) { covered += to - from; });
+  std::promise<int> cpus;
+  pool.Submit([&cpus] {
+    cpu_set_t set;
+    sched_getaffinity(0, sizeof(set), &set);
+    cpus.set_value(CPU_COUNT(&set));
+  });
+  ASSERT_EQ(cpus.get_future().get(), 1);
+  ASSERT_EQ(covered, 64);
+}
+
+TEST(test_numa, pinned_from_workers) {
+  S21Executor pool(3, true);
+  // a pinned ParallelFor issued by one of the workers runs on that worker
+  std::promise<int> nested;
+  pool.Submit([&] {
+    int covered = 0;
+    pool.ParallelFor(0, 64, 1, [&](int from, int to) { covered += to - from; });
+    nested.set_value(covered);
+  });
+  std::future<int> result = nested.get_future();
+  ASSERT_EQ(result.wait_for(std::chrono::seconds(30)),
+            std::future_status::ready);
+  ASSERT_EQ(result.get(), 64);
+  std::promise<bool> refused;
+  pool.Submit([&] {
+    try {
+      pool.ForEachWorker([](int) {});
+      refused.set_value(false);
+    } catch (const std::logic_error&) {
+      refused.set_value(true);
+    }
+  });
+  ASSERT_TRUE(refused.get_future().get());
+
+  // concurrent calls do not share out their tasks between each other
+  std::atomic<int> runs{0};
+  std::vector<std::thread> callers;
+  for (int t = 0; t < 4; ++t) {
+    callers.emplace_back([&] {
+      for (int k = 0; k < 10; ++k) pool.ForEachWorker([&](int) { ++runs; });
+    });
+  }
+  for (std::thread& caller : callers) caller.join();
+  ASSERT_EQ(runs, 4 * 10 * 3);
+
+  // first-touch allocations from a worker of the shared pinned pool
+  S21Matrix::setPlacement(S21Placement::kFirstTouch);
+  std::promise<double> allocated;
+  S21Executor::Pinned().Submit([&allocated] {
+    S21Matrix m(512, 512);
+    m(511, 511) = 1;
+    allocated.set_value(m.Sum());
+  });
+  std::future<double> sum = allocated.get_future();
+  const bool ready =
+      sum.wait_for(std::chrono::seconds(30)) == std::future_status::ready;
+  S21Matrix::setPlacement(S21Placement::kDefault);
+  ASSERT_TRUE(ready);
+  ASSERT_EQ(sum.get(), 1);
+}
+
+// copy-on-write is a global switch; restore it even when a test fails early
+class test_cow : public ::testing::Test {
+ protected:
+  void SetUp() override { _saved = S21Matrix::getCopyOnWrite(); }
+  void TearDown() override { S21Matrix::setCopyOnWrite(_saved); }
+
+ private:
+  bool _saved = false;
+};
+
+TEST_F(test_cow, shared_until_written) {
+  S21Matrix::setCopyOnWrite(true);
+  S21Matrix a = filled(3, 3, 1);
+  a(0, 0) = 5;
+  a(2, 1) = -3;
+  S21Matrix b(a), c;
+  c = a;
+  // reads through const references keep the buffer shared
+  const S21Matrix &ca = a, &cb = b;
+  ASSERT_TRUE(a.isShared());
+  ASSERT_EQ(cb.data(), ca.data());
+  ASSERT_EQ(cb[1][1], ca(1, 1));
+
+  b(1, 1) = 100;
+  ASSERT_FALSE(b.isShared());
+  ASSERT_TRUE(a.isShared());
+  ASSERT_NE(ca(1, 1), 100);
+  c += a;
+  ASSERT_FALSE(a.isShared());
+  ASSERT_TRUE(c == a * 2.0);
+  b[0][0] = 5;
+  ASSERT_EQ(cb(0, 0), 5);
+
+  S21Matrix d(a);
+  S21Matrix x = d.Solve(filled(3, 1, 1));
+  ASSERT_TRUE(d.isShared());
+  d.setRow(4);
+  ASSERT_FALSE(a.isShared());
+  S21Matrix::setCopyOnWrite(false);
+  S21Matrix e(a), f = filled(2, 2, 1), g(f);
+  ASSERT_TRUE(e.isShared());
+  ASSERT_FALSE(g.isShared());
+}
+
+TEST_F(test_cow, concurrent_copies) {
+  S21Matrix::setCopyOnWrite(true);
+  S21Matrix base = filled(64, 64, 1);
+  S21Matrix::setCopyOnWrite(false);
+  std::vector<std::thread> threads;
+  std::atomic<int> ok{0};
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&base, &ok, t] {
+      for (int k = 0; k < 100; ++k) {
+        S21Matrix copy(base);
+        if (k % 2) copy(t, t) += 1;
+        const S21Matrix &cc = copy, &cbase = base;
+        ok += cc(t, t) == cbase(t, t) + k % 2;
+      }
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  ASSERT_EQ(ok, 400);
+  ASSERT_FALSE(base.isShared());
+}
+
+TEST(test_cache, memoises_until_modified) {
+  S21MatrixCache cache;
+  S21Matrix a = filled(3, 3, 1);
+  a(0, 0) = 5;
+  const double det = a.Determinant();
+  ASSERT_EQ(cache.Determinant(a), det);
+  ASSERT_EQ(cache.Determinant(a), det);
+  ASSERT_TRUE(*cache.InverseMatrix(a) == a.InverseMatrix());
+  ASSERT_EQ(cache.getHits(), 1u);
+  ASSERT_EQ(cache.getMisses(), 2u);
+  ASSERT_EQ(cache.getSize(), 1u);
+
+  a(2, 2) += 1;
+  ASSERT_EQ(cache.Determinant(a), a.Determinant());
+  ASSERT_NE(cache.Determinant(a), det);
+  S21Matrix b(a);
+  b *= 2.0;
+  ASSERT_EQ(cache.Determinant(b), 8 * a.Determinant());
+  b = a;
+  ASSERT_EQ(cache.Determinant(b), a.Determinant());
+  ASSERT_TRUE(cache.EigenSymmetric(b)->values == b.EigenSymmetric().values);
+  ASSERT_EQ(cache.getMisses(), 6u);
+
+  cache.Invalidate(a);
+  ASSERT_EQ(cache.getSize(), 1u);
+  cache.Clear();
+  ASSERT_EQ(cache.getSize(), 0u);
+}
+
+TEST(test_cache, capacity_and_threads) {
+  S21MatrixCache small(2);
+  S21Matrix a = filled(2, 2, 1), b = filled(2, 2, 2), c = filled(2, 2, 3);
+  small.Determinant(a);
+  small.Determinant(b);
+  small.Determinant(c);
+  ASSERT_EQ(small.getSize(), 2u);
+  small.Determinant(a);
+  ASSERT_EQ(small.getMisses(), 4u);
+
+  S21MatrixCache cache;
+  S21Matrix m = filled(6, 6, 1.5);
+  for (int i = 0; i < 6; ++i) m(i, i) += 10;
+  const S21Matrix expected = m.InverseMatrix();
+  std::vector<std::thread> threads;
+  std::atomic<int> ok{0};
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&] {
+      for (int k = 0; k < 20; ++k) ok += *cache.InverseMatrix(m) == expected;
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  ASSERT_EQ(ok, 80);
+  ASSERT_EQ(cache.getHits() + cache.getMisses(), 80u);
+}
+
+TEST(test_cache, const_reads_and_shared_results) {
+  S21MatrixCache cache;
+  S21Matrix a = filled(3, 3, 1);
+  a(0, 0) = 5;
+  std::shared_ptr<const S21Matrix> inv = cache.InverseMatrix(a);
+  // reads through a const reference do not count as modifications
+  const S21Matrix& ca = a;
+  double sum = ca(1, 1) + ca[0][0] + ca.data()[2] + ca.NormFrobenius();
+  ASSERT_NE(sum, 0);
+  ASSERT_EQ(cache.InverseMatrix(a).get(), inv.get());
+  ASSERT_EQ(cache.getHits(), 1u);
+  // a non-const read does, and the result held by the caller stays intact
+  a(1, 1);
+  ASSERT_NE(cache.InverseMatrix(a).get(), inv.get());
+  ASSERT_TRUE(*inv == a.InverseMatrix());
+  ASSERT_EQ(cache.getMisses(), 2u);
+}
+
+TEST(test_cache, raw_writes_need_mark_modified) {
+  S21MatrixCache cache;
+  S21Matrix a(2, 2);
+  double* raw = a.data();
+  raw[0] = 3;
+  raw[1] = raw[2] = raw[3] = 1;
+  ASSERT_EQ(cache.Determinant(a), 2);
+  // the write after the lookup is invisible until it is recorded
+  raw[3] = 2;
+  ASSERT_EQ(cache.Determinant(a), 2);
+  a.MarkModified();
+  ASSERT_EQ(cache.Determinant(a), 5);
+
+  std::vector<double> buffer = {3, 1, 1, 1};
+  S21Matrix view = S21Matrix::Wrap(buffer.data(), 2, 2);
+  ASSERT_EQ(cache.Determinant(view), 2);
+  buffer[0] = 5;
+  view.MarkModified();
+  ASSERT_EQ(cache.Determinant(view), 4);
+
+  // content keys see every write, and equal words hash equally
+  S21MatrixCache content(4, S21CacheKey::kContent);
+  ASSERT_EQ(content.Determinant(view), 4);
+  buffer[3] = 2;
+  ASSERT_EQ(content.Determinant(view), 9);
+  ASSERT_EQ(content.Determinant(S21Matrix(view)), 9);
+  ASSERT_EQ(content.getHits(), 1u);
+}
+
+TEST(test_cache, entries_follow_matrices) {
+  S21MatrixCache cache;
+  S21Matrix a = filled(3, 3, 1);
+  a(0, 0) = 5;
+  cache.Determinant(a);
+  std::shared_ptr<const S21Matrix> inv;
+  {
+    S21Matrix b(a);
+    inv = cache.InverseMatrix(b);
+    ASSERT_EQ(cache.getSize(), 2u);
+  }
+  // the entry of the destroyed copy is gone, its result is still usable
+  ASSERT_EQ(cache.getSize(), 1u);
+  ASSERT_TRUE(*inv == a.InverseMatrix());
+
+  S21MatrixCache content(16, S21CacheKey::kContent);
+  ASSERT_EQ(content.getMode(), S21CacheKey::kContent);
+  inv = content.InverseMatrix(a);
+  S21Matrix b(a);
+  ASSERT_EQ(content.InverseMatrix(b).get(), inv.get());
+  b(2, 2) += 1;
+  ASSERT_NE(content.InverseMatrix(b).get(), inv.get());
+  ASSERT_EQ(content.getHits(), 1u);
+  ASSERT_EQ(content.getMisses(), 2u);
+  ASSERT_EQ(content.getSize(), 2u);
+}
+
+TEST(test_structured, band) {
+  // tridiagonal -1, 4, -1 plus one extra superdiagonal
+  const int n = 7;
+  S21BandMatrix band(n, 1, 2);
+  for (int i = 0; i < n; ++i) {
+    band(i, i) = i % 3 ? 4 : 0.5;  // small pivots force row swaps
+    if (i > 0) band(i, i - 1) = -1 - i;
+    if (i + 1 < n) band(i, i + 1) = -1;
+    if (i + 2 < n) band(i, i + 2) = 0.25 * i;
+  }
+  S21Matrix dense = band.ToMatrix();
+  S21Matrix b = filled(n, 2, 1);
+  S21Tolerance tol;
+  tol.rel = 1e-9;
+
+  ASSERT_TRUE(band.Mul(b).EqMatrix(dense * b, tol));
+  S21Matrix x = band.Solve(b);
+  ASSERT_TRUE((dense * x).EqMatrix(b, tol));
+  ASSERT_NEAR(band.Determinant(), S21BandMatrix(dense, 6, 6).Determinant(),
+              1e-9 * std::fabs(band.Determinant()));
+  ASSERT_NEAR(S21BandMatrix(filled(5, 5, 1), 4, 4).Determinant(),
+              filled(5, 5, 1).Determinant(), 1e-9);
+  ASSERT_EQ(static_cast<const S21BandMatrix&>(band)(0, 5), 0);
+  EXPECT_THROW(band(3, 0), std::out_of_range);
+  EXPECT_THROW(band.Mul(S21Matrix(3, 1)), std::invalid_argument);
+  EXPECT_THROW(S21BandMatrix(n, 1, 1).Solve(b), std::logic_error);
+}
+
+TEST(test_structured, triangular) {
+  S21Matrix m = filled(4, 4, 2);
+  for (int i = 0; i < 4; ++i) m(i, i) += 3;
+  S21Matrix b = filled(4, 3, -1);
+  S21Tolerance tol;
+  tol.rel = 1e-9;
+  for (S21Triangle uplo : {S21Triangle::kLower, S21Triangle::kUpper}) {
+    S21TriangularMatrix t(m, uplo);
+    S21Matrix dense = t.ToMatrix();
+    ASSERT_EQ(dense(1, 2), uplo == S21Triangle::kUpper ? m(1, 2) : 0);
+    ASSERT_TRUE(t.Mul(b).EqMatrix(dense * b, tol));
+    ASSERT_TRUE((dense * t.Solve(b)).EqMatrix(b, tol));
+    ASSERT_DOUBLE_EQ(t.Determinant(), m(0, 0) * m(1, 1) * m(2, 2) * m(3, 3));
+  }
+  S21TriangularMatrix lower(3, S21Triangle::kLower);
+  EXPECT_THROW(lower(0, 1) = 1, std::out_of_range);
+  EXPECT_THROW(lower.Solve(S21Matrix(3, 1)), std::logic_error);
+}
+
+TEST(test_structured, symmetric) {
+  S21Matrix m = filled(5, 5, 1);
+  m = m * m.Transpose();
+  for (int i = 0; i < 5; ++i) m(i, i) += 1;
+  S21SymmetricMatrix spd(m);
+  S21Matrix b = filled(5, 2, 0.5);
+  S21Tolerance tol;
+  tol.rel = 1e-9;
+  ASSERT_TRUE(spd.ToMatrix() == m);
+  ASSERT_TRUE(spd.Mul(b).EqMatrix(m * b, tol));
+  ASSERT_TRUE((m * spd.Solve(b)).EqMatrix(b, tol));
+  ASSERT_NEAR(spd.Determinant(), S21BandMatrix(m, 4, 4).Determinant(),
+              1e-9 * spd.Determinant());
+
+  // indefinite: Cholesky fails and Bunch-Kaufman takes over
+  S21SymmetricMatrix indefinite(2);
+  indefinite(0, 1) = 2;
+  indefinite(1, 1) = 1;
+  ASSERT_EQ(indefinite(1, 0), 2);
+  ASSERT_DOUBLE_EQ(indefinite.Determinant(), -4);
+  S21Matrix x = indefinite.Solve(filled(2, 1, 1));
+  ASSERT_TRUE((indefinite.ToMatrix() * x).EqMatrix(filled(2, 1, 1), tol));
+
+  // a zero diagonal forces 2 x 2 pivots, the off-diagonal pattern swaps
+  const int n = 9;
+  S21SymmetricMatrix saddle(n);
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < i; ++j) saddle(i, j) = ((i * 5 + j * 3) % 7) - 3;
+  }
+  saddle(4, 4) = 0.5;
+  const S21Matrix dense = saddle.ToMatrix();
+  S21Matrix rhs = filled(n, 3, -0.25);
+  S21Tolerance loose;
+  loose.rel = 1e-9;
+  loose.abs = 1e-9;
+  ASSERT_TRUE((dense * saddle.Solve(rhs)).EqMatrix(rhs, loose));
+  const double det = S21BandMatrix(dense, n - 1, n - 1).Determinant();
+  ASSERT_NEAR(saddle.Determinant(), det, 1e-9 * std::fabs(det));
+  // a repeated row makes it singular
+  for (int j = 0; j < n; ++j) {
+    if (j != 1) saddle(1, j) = saddle(0, j);
+  }
+  saddle(1, 1) = saddle(0, 1);
+  saddle(0, 0) = saddle(0, 1);
+  ASSERT_EQ(saddle.Determinant(), 0);
+  EXPECT_THROW(saddle.Solve(rhs), std::logic_error);
+}
+
+TEST(test_vector, gemv) {
+  S21Matrix a = filled(300, 250, 0.01);
+  S21Vector x(S21Matrix(filled(250, 1, 0.5))), xt(filled(1, 300, -1));
+  S21Executor pool(3);
+  S21Tolerance tol;
+  tol.rel = 1e-12;
+
+  S21Vector y;
+  y.Gemv(S21Op::kNoTrans, 2, a, x);
+  ASSERT_TRUE(y.EqVector(S21Vector(a * x.ToMatrix() * 2.0), tol));
+  S21Vector par(300);
+  par.Gemv(S21Op::kNoTrans, 2, a, x, 0, &pool);
+  ASSERT_TRUE(par.EqVector(y, tol));
+  par.Gemv(S21Op::kNoTrans, 1, a, x, -0.5, &pool);
+  ASSERT_LT(par.Norm(), 1e-9 * y.Norm());
+
+  S21Vector yt(S21Matrix(filled(250, 1, 3)));
+  S21Matrix expected = a.Transpose() * xt.ToMatrix() + filled(250, 1, 3);
+  yt.Gemv(S21Op::kTrans, 1, a, xt, 1, &pool);
+  ASSERT_TRUE(yt.EqVector(S21Vector(expected), tol));
+
+  S21Matrix sq = filled(3, 3, 1);
+  S21Vector v = {1, 2, 3};
+  S21Vector w = v;
+  v.Gemv(S21Op::kNoTrans, 1, sq, v);
+  ASSERT_TRUE(v.EqVector(S21Vector(sq * w.ToMatrix())));
+  EXPECT_THROW(y.Gemv(S21Op::kTrans, 1, a, x), std::invalid_argument);
+  EXPECT_THROW(w.Gemv(S21Op::kNoTrans, 1, a, x, 1), std::invalid_argument);
+}
+
+TEST(test_vector, ger_axpy_dot) {
+  S21Vector x = {1, 2}, y = {3, 4, 5};
+  S21Matrix a(2, 3);
+  S21Executor pool(2);
+  a.Ger(2, x, y, &pool);
+  a.Ger(-1, x, y);
+  ASSERT_EQ(a(1, 2), 10);
+  ASSERT_EQ(a(0, 0), 3);
+  EXPECT_THROW(a.Ger(1, y, x), std::invalid_argument);
+
+  S21Vector z = {1, 1, 1};
+  z.Axpy(-2, y);
+  ASSERT_EQ(z(2), -9);
+  ASSERT_EQ(y.Dot(z), 3 * -5 + 4 * -7 + 5 * -9);
+  ASSERT_DOUBLE_EQ(S21Vector({3, 4}).Norm(), 5);
+  EXPECT_THROW(z.Axpy(1, x), std::invalid_argument);
+  EXPECT_THROW(z(3), std::out_of_range);
+  EXPECT_THROW(S21Vector(filled(2, 2, 1)), std::invalid_argument);
+  z.setSize(4);
+  ASSERT_EQ(z.getSize(), 4);
+  ASSERT_EQ(z(3), 0);
+}
+
+TEST(test_tiled, task_graph) {
+  S21TaskGraph graph;
+  std::vector<int> order;
+  std::mutex mutex;
+  auto log = [&](int id) {
+    return [&, id] {
+      std::lock_guard<std::mutex> lock(mutex);
+      order.push_back(id);
+    };
+  };
+  const int a = graph.Add(log(0));
+  const int b = graph.Add(log(1), {a});
+  const int c = graph.Add(log(2), {a});
+  graph.Add(log(3), {b, c, b});
+  S21Executor pool(3);
+  graph.Run(&pool);
+  ASSERT_EQ(order.size(), 4u);
+  ASSERT_EQ(order.front(), 0);
+  ASSERT_EQ(order.back(), 3);
+  order.clear();
+  graph.Run();
+  ASSERT_EQ(order.size(), 4u);
+  EXPECT_THROW(graph.Add(log(4), {7}), std::out_of_range);
+
+  S21TaskGraph failing;
+  const int bad = failing.Add([] { throw std::logic_error("task"); });
+  failing.Add(log(5), {bad});
+  EXPECT_THROW(failing.Run(&pool), std::logic_error);
+  ASSERT_EQ(order.size(), 4u);
+}
+
+// full-rank test matrix
+S21Matrix tiledInput(int rows, int cols) {
+  S21Matrix m = filled(rows, cols, 0.5);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) m(i, j) += (i * 3 + j * 5) % 7;
+    if (i < cols) m(i, i) += 10;
+  }
+  return m;
+}
+
+TEST(test_tiled, cholesky) {
+  S21Matrix f = tiledInput(10, 10);
+  S21Matrix a = f * f.Transpose();
+  S21Matrix b = filled(10, 3, 1);
+  S21Executor pool(3);
+  S21Tolerance tol;
+  tol.rel = 1e-9;
+  tol.abs = 1e-9;
+  for (int tile : {3, 4, 16}) {
+    S21Cholesky chol(a, tile, &pool);
+    const S21Matrix& l = chol.getL();
+    ASSERT_EQ(l(0, 9), 0);
+    ASSERT_TRUE((l * l.Transpose()).EqMatrix(a, tol));
+    ASSERT_TRUE((a * chol.Solve(b)).EqMatrix(b, tol));
+  }
+  S21Matrix small = a;
+  small.setRow(6);
+  small.setCol(6);
+  S21Cholesky serial(small, 4);
+  ASSERT_NEAR(serial.Determinant(), small.Determinant(),
+              1e-9 * small.Determinant());
+  EXPECT_THROW(S21Cholesky(filled(3, 3, 1), 2, &pool), std::logic_error);
+  EXPECT_THROW(S21Cholesky(filled(3, 2, 1)), std::invalid_argument);
+  EXPECT_THROW(S21Cholesky(a, 0), std::invalid_argument);
+  EXPECT_THROW(serial.Solve(b), std::invalid_argument);
+}
+
+TEST(test_tiled, qr) {
+  S21Matrix a = tiledInput(11, 7);
+  S21Matrix b = filled(11, 2, -1);
+  for (int i = 0; i < 11; ++i) b(i, 1) += i * i;
+  S21Executor pool(3);
+  S21Tolerance tol;
+  tol.rel = 1e-9;
+  tol.abs = 1e-9;
+  for (int tile : {2, 3, 8}) {
+    S21QR qr(a, tile, &pool);
+    S21Matrix r = qr.getR();
+    ASSERT_EQ(r(3, 1), 0);
+    ASSERT_TRUE((r.Transpose() * r).EqMatrix(a.Transpose() * a, tol));
+    // least squares: the residual is orthogonal to the columns of a
+    S21Matrix x = qr.Solve(b);
+    S21Matrix normal = a.Transpose() * (a * x - b);
+    ASSERT_LT(normal.MaxAbs(), 1e-9 * b.MaxAbs() * a.MaxAbs());
+  }
+  S21Matrix sq = tiledInput(6, 6);
+  S21QR square(sq, 4, &pool);
+  ASSERT_NEAR(square.Determinant(), sq.Determinant(),
+              1e-9 * std::fabs(sq.Determinant()));
+  ASSERT_TRUE((sq * square.Solve(filled(6, 1, 2))).EqMatrix(filled(6, 1, 2),
+                                                            tol));
+  EXPECT_THROW(S21QR(filled(2, 3, 1)), std::invalid_argument);
+  EXPECT_THROW(S21QR(a).Determinant(), std::invalid_argument);
+  EXPECT_THROW(S21QR(S21Matrix(3, 3)).Solve(filled(3, 1, 1)),
+               std::logic_error);
+}
+
+TEST(test_tiled, large_determinant) {
+  // c * I + u * u^T has determinant c^n * (1 + |u|^2 / c), far beyond the
+  // range of a double for these sizes
+  const int n = 400;
+  const double c = 1e3;
+  S21Matrix a(n, n);
+  double uu = 0;
+  for (int i = 0; i < n; ++i) {
+    const double ui = 1 + i % 5;
+    uu += ui * ui;
+    for (int j = 0; j < n; ++j) a(i, j) = ui * (1 + j % 5);
+    a(i, i) += c;
+  }
+  const double expected = n * std::log(c) + std::log1p(uu / c);
+  S21Executor pool(3);
+  S21Cholesky chol(a, 64, &pool);
+  ASSERT_NEAR(chol.LogDeterminant(), expected, 1e-9 * expected);
+  ASSERT_TRUE(std::isinf(chol.Determinant()));
+  S21QR qr(a, 64, &pool);
+  int sign = 0;
+  ASSERT_NEAR(qr.LogDeterminant(&sign), expected, 1e-9 * expected);
+  ASSERT_EQ(sign, 1);
+
+  // half the diagonal is c, half 1 / c: det = 1, while a running product
+  // of the pivots overflows half way through
+  S21Matrix d(n, n);
+  for (int i = 0; i < n; ++i) d(i, i) = i < n / 2 ? c : 1 / c;
+  ASSERT_NEAR(S21Cholesky(d, 64, &pool).Determinant(), 1, 1e-9);
+  d(0, 0) = -c;
+  ASSERT_NEAR(S21QR(d, 64, &pool).Determinant(), -1, 1e-9);
+  ASSERT_EQ(S21QR(S21Matrix(3, 3)).Determinant(), 0);
+}
+
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();